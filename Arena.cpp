@@ -0,0 +1,72 @@
+#include "Arena.h"
+#include <cstdlib>
+
+Arena::Arena(size_t chunkSize)
+    : chunkSize(chunkSize)
+{
+}
+
+Arena::~Arena()
+{
+    Q_FOREACH(auto chunk, chunks)
+        std::free(chunk.data);
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    while(current < chunks.size())
+    {
+        const Chunk& chunk = chunks.at(current);
+        quintptr begin = reinterpret_cast<quintptr>(chunk.data) + offset;
+        quintptr aligned = (begin + alignment - 1) & ~static_cast<quintptr>(alignment - 1);
+        size_t end = offset + (aligned - begin) + size;
+        if(end <= chunk.size)
+        {
+            offset = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        // current chunk is exhausted, continue in the next one
+        usedBefore += offset;
+        offset = 0;
+        ++current;
+    }
+
+    Chunk chunk;
+    chunk.size = qMax(chunkSize, size + alignment);
+    chunk.data = static_cast<char*>(std::malloc(chunk.size));
+    if(!chunk.data)
+        qFatal("Arena: out of memory allocating %zu bytes", chunk.size);
+    chunks.append(chunk);
+    return allocate(size, alignment);
+}
+
+void Arena::release()
+{
+    // merge the chunks of a grown arena, so the next game of the same size
+    // is served from a single block without touching the heap
+    if(chunks.size() > 1)
+    {
+        size_t total = capacity();
+        Q_FOREACH(auto chunk, chunks)
+            std::free(chunk.data);
+        chunks.clear();
+        chunkSize = qMax(chunkSize, total);
+    }
+    current = 0;
+    offset = 0;
+    usedBefore = 0;
+}
+
+size_t Arena::capacity() const
+{
+    size_t total = 0;
+    Q_FOREACH(auto chunk, chunks)
+        total += chunk.size;
+    return total;
+}
+
+size_t Arena::used() const
+{
+    return usedBefore + offset;
+}
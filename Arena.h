@@ -0,0 +1,50 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QtCore/QtCore>
+#include <new>
+#include <type_traits>
+
+// Monotonic allocator for per-game state. Allocation bumps a pointer inside
+// large chunks; nothing is freed individually, release() drops everything in
+// one operation and keeps the memory for the next game.
+class Arena
+{
+public:
+    explicit Arena(size_t chunkSize = 64 * 1024);
+    ~Arena();
+
+    void* allocate(size_t size, size_t alignment);
+    void release();
+
+    size_t capacity() const;
+    size_t used() const;
+
+    template<typename T>
+    T* create(int count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena memory is released without running destructors");
+        T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        for(int i=0;i<count;++i)
+            new (data + i) T();
+        return data;
+    }
+
+private:
+    Q_DISABLE_COPY(Arena)
+
+    struct Chunk
+    {
+        char* data;
+        size_t size;
+    };
+
+    QVector<Chunk> chunks;
+    int current = 0;        // chunk allocations are served from
+    size_t offset = 0;      // first free byte in the current chunk
+    size_t usedBefore = 0;  // bytes consumed in chunks before the current one
+    size_t chunkSize;
+};
+
+#endif // ARENA_H
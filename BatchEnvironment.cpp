@@ -0,0 +1,144 @@
+#include "BatchEnvironment.h"
+#include "BoardGenerator.h"
+#include "Observation.h"
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+BatchEnvironment::BatchEnvironment(int count, const Grid& grid, int mines, quint32 seed)
+    : grid(grid)
+    , mines(mines)
+    , seed(seed)
+    , boards(count, 0)
+    , current(count)
+    , spares(count)
+    , used(count, 0)
+{
+    games.reserve(count);
+    for(int i=0;i<count;++i)
+    {
+        // snapshots and undo history would only slow the steps down
+        MineSweeper* game = new MineSweeper();
+        game->setHeadless(true);
+        games << game;
+    }
+
+    // a few tasks per core even out games that end and restart
+    int chunkCount = qBound(1, QThread::idealThreadCount() * 4, qMax(1, count));
+    for(int c=0;c<chunkCount;++c)
+        chunks << qMakePair(count * c / chunkCount, count * (c + 1) / chunkCount);
+}
+
+BatchEnvironment::~BatchEnvironment()
+{
+    refilling.waitForFinished();
+    qDeleteAll(games);
+}
+
+int BatchEnvironment::getCount() const
+{
+    return games.size();
+}
+
+Grid BatchEnvironment::getGrid() const
+{
+    return grid;
+}
+
+int BatchEnvironment::getMineCount() const
+{
+    return mines;
+}
+
+MineSweeper* BatchEnvironment::getGame(int index) const
+{
+    Q_ASSERT(busy.loadAcquire() == 0);
+    return games.at(index);
+}
+
+void BatchEnvironment::reset(quint8* observations)
+{
+    refilling.waitForFinished();
+    const int cells = grid.count();
+    forEachGame([=](int i)
+    {
+        current[i] = nextBoard(i);
+        spares[i] = nextBoard(i);
+        used[i] = 0;
+        games.at(i)->startGame(current.at(i));
+        const quint8* codes = games.at(i)->observe().data;
+        std::copy(codes, codes + cells, observations + i * cells);
+    });
+}
+
+void BatchEnvironment::step(const Action* actions, float* rewards, quint8* terminals,
+                            quint8* observations)
+{
+    // boards taken by the previous step are generated by now
+    refilling.waitForFinished();
+    const int cells = grid.count();
+    forEachGame([=](int i)
+    {
+        MineSweeper* game = games.at(i);
+        const Action& action = actions[i];
+        bool valid = (action.cell >= 0) && (action.cell < cells)
+                     && ((action.button == Qt::LeftButton) || (action.button == Qt::MidButton)
+                         || (action.button == Qt::RightButton));
+        int remaining = game->getRemaining();
+        if(valid)
+            game->play(action.cell, action.button);
+
+        MineSweeper::State state = game->getState();
+        rewards[i] = (!valid || (state == MineSweeper::State::Fail))
+                     ? -1 : remaining - game->getRemaining();
+        terminals[i] = (state != MineSweeper::State::Running);
+        if(terminals[i])
+        {
+            // the finished board is kept as spare, so nothing is freed here
+            std::swap(current[i], spares[i]);
+            game->startGame(current.at(i));
+            used[i] = 1;
+        }
+        const quint8* codes = game->observe().data;
+        std::copy(codes, codes + cells, observations + i * cells);
+    });
+    if(used.contains(1))
+        refilling = QtConcurrent::run([this]() { refill(); });
+}
+
+QSharedPointer<const Board> BatchEnvironment::nextBoard(int index)
+{
+    // seeds depend on game and board only, not on the thread scheduling
+    quint32 board = seed + index + static_cast<quint32>(boards.at(index)) * games.size();
+    ++boards[index];
+    return BoardGenerator::generate(grid, mines, board);
+}
+
+void BatchEnvironment::refill()
+{
+    for(int i=0;i<games.size();++i)
+    {
+        if(!used.at(i))
+            continue;
+        spares[i] = nextBoard(i);
+        used[i] = 0;
+    }
+}
+
+template<typename Function>
+void BatchEnvironment::forEachGame(Function function)
+{
+    // every game is touched by one task only, and by nobody else until
+    // all tasks are done
+    bool idle = busy.testAndSetAcquire(0, 1);
+    Q_ASSERT(idle);
+    Q_UNUSED(idle);
+    QtConcurrent::blockingMap(chunks, [&](const QPair<int, int>& chunk)
+    {
+        for(int i=chunk.first;i<chunk.second;++i)
+        {
+            Q_ASSERT(games.at(i)->isHeadless());
+            function(i);
+        }
+    });
+    busy.storeRelease(0);
+}
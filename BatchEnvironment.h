@@ -0,0 +1,65 @@
+#ifndef BATCHENVIRONMENT_H
+#define BATCHENVIRONMENT_H
+
+#include <QtCore/QtCore>
+#include "MineSweeper.h"
+
+// Many games of one board layout stepped in lockstep, for bots and training.
+// Every board is a headless MineSweeper engine and actions go through
+// MineSweeper::play, so results match the GUI. Results are written to
+// buffers of the caller, the boards are stepped in parallel across cores.
+// Calls must come from one thread at a time. The engines are handed to pool
+// threads only inside reset() and step(), which wait for them to finish,
+// so they must not be touched from elsewhere meanwhile. The next board of
+// every game is generated in the background between steps, a step itself
+// allocates nothing
+class BatchEnvironment
+{
+public:
+    struct Action
+    {
+        int cell;
+        Qt::MouseButton button;
+    };
+
+    BatchEnvironment(int count, const Grid& grid, int mines, quint32 seed = 0);
+    ~BatchEnvironment();
+
+    int getCount() const;
+    Grid getGrid() const;
+    int getMineCount() const;
+    // not while reset() or step() runs
+    MineSweeper* getGame(int index) const;
+
+    // starts a new board everywhere. Observations are Observation codes,
+    // count * grid.count() bytes, board after board
+    void reset(quint8* observations);
+
+    // applies one action to every board. Rewards are the safe tiles the
+    // action uncovered, -1 when it hit a mine or the action is not a tile and
+    // button of the board, which leaves the board alone. A finished board
+    // gets terminal set and restarts at once, its observation shows the new board
+    void step(const Action* actions, float* rewards, quint8* terminals, quint8* observations);
+
+private:
+    Q_DISABLE_COPY(BatchEnvironment)
+
+    QSharedPointer<const Board> nextBoard(int index);
+    void refill();
+    template<typename Function>
+    void forEachGame(Function function);
+
+    Grid grid;
+    int mines;
+    quint32 seed;
+    QVector<MineSweeper*> games;
+    QVector<int> boards;                // boards generated per game, for the seeds
+    QVector<QSharedPointer<const Board> > current;  // board of every game
+    QVector<QSharedPointer<const Board> > spares;   // next board of every game
+    QVector<quint8> used;               // spares taken by the last step
+    QFuture<void> refilling;
+    QVector<QPair<int, int> > chunks;   // game ranges stepped by one task
+    QAtomicInt busy;                    // engines are out on pool threads
+};
+
+#endif // BATCHENVIRONMENT_H
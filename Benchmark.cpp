@@ -0,0 +1,969 @@
+#include "Benchmark.h"
+#include "BoardGenerator.h"
+#include "MineSweeper.h"
+#include "MineField.h"
+#include "BatchEnvironment.h"
+#include "BotServer.h"
+#include "BitboardSolver.h"
+#include "PatternSolver.h"
+#include "BoardSnapshot.h"
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+// per cell reference for BitboardSolver: every number recounts its
+// neighbours until no mine is found, then the mine count is applied
+BitboardSolver::Result naiveSolve(const BoardSnapshot& snapshot)
+{
+    enum Known : quint8 {Unknown, Mine, Revealed};
+    const Grid& grid = snapshot.board->grid;
+    const QVector<quint8>& numbers = snapshot.board->surroundingMines;
+    QVector<quint8> known(grid.count());
+    QVector<bool> safe(grid.count(), false);
+    QVector<bool> mines(grid.count(), false);
+    for(int i=0;i<grid.count();++i)
+    {
+        Tile::State state = snapshot.tileState(i);
+        known[i] = ((state == Tile::Cover) || (state == Tile::Tag))
+                   ?Unknown:((state == Tile::Flag)?Mine:Revealed);
+    }
+
+    bool found = true;
+    while(found)
+    {
+        found = false;
+        for(int i=0;i<grid.count();++i)
+        {
+            if((snapshot.tileState(i) != Tile::Uncover) || (numbers.at(i) == 0))
+                continue;
+            int flags = 0;
+            int unknown = 0;
+            grid.forEachNeighbour(i, [&](int neighbour)
+            {
+                flags += (known.at(neighbour) == Mine);
+                unknown += (known.at(neighbour) == Unknown);
+            });
+            if(unknown == 0)
+                continue;
+            if(flags == numbers.at(i))
+            {
+                grid.forEachNeighbour(i, [&](int neighbour)
+                {
+                    if(known.at(neighbour) == Unknown)
+                        safe[neighbour] = true;
+                });
+            }
+            else if(flags + unknown == numbers.at(i))
+            {
+                grid.forEachNeighbour(i, [&](int neighbour)
+                {
+                    if(known.at(neighbour) != Unknown)
+                        return;
+                    known[neighbour] = Mine;
+                    mines[neighbour] = true;
+                });
+                found = true;
+            }
+        }
+    }
+
+    int left = snapshot.mineCount;
+    int open = 0;
+    for(int i=0;i<grid.count();++i)
+    {
+        left -= mines.at(i);
+        open += (known.at(i) == Unknown) && !safe.at(i);
+    }
+    BitboardSolver::Result result;
+    for(int i=0;i<grid.count();++i)
+    {
+        if((open > 0) && ((left == 0) || (left == open)) && (known.at(i) == Unknown) && !safe.at(i))
+        {
+            if(left == 0)
+                safe[i] = true;
+            else
+                mines[i] = true;
+        }
+        if(safe.at(i))
+            result.safe << i;
+        if(mines.at(i))
+            result.mines << i;
+    }
+    return result;
+}
+}
+
+QStringList Benchmark::names()
+{
+    return QStringList() << QStringLiteral("restart")
+                         << QStringLiteral("click")
+                         << QStringLiteral("analyze")
+                         << QStringLiteral("latency")
+                         << QStringLiteral("render")
+                         << QStringLiteral("threads")
+                         << QStringLiteral("batch")
+                         << QStringLiteral("bot")
+                         << QStringLiteral("frontier")
+                         << QStringLiteral("solver")
+                         << QStringLiteral("patterns")
+                         << QStringLiteral("chord")
+                         << QStringLiteral("undo");
+}
+
+int Benchmark::run(const QStringList& names)
+{
+    QTextStream out(stdout);
+    Q_FOREACH(auto name, names)
+    {
+        if(name == QStringLiteral("restart"))
+            restart(out);
+        else if(name == QStringLiteral("click"))
+            click(out);
+        else if(name == QStringLiteral("analyze"))
+            analyze(out);
+        else if(name == QStringLiteral("latency"))
+            latency(out);
+        else if(name == QStringLiteral("render"))
+            render(out);
+        else if(name == QStringLiteral("threads"))
+            threads(out);
+        else if(name == QStringLiteral("batch"))
+            batch(out);
+        else if(name == QStringLiteral("bot"))
+            bot(out);
+        else if(name == QStringLiteral("frontier"))
+            frontier(out);
+        else if(name == QStringLiteral("solver"))
+            solver(out);
+        else if(name == QStringLiteral("patterns"))
+            patterns(out);
+        else if(name == QStringLiteral("chord"))
+            chord(out);
+        else if(name == QStringLiteral("undo"))
+            undo(out);
+        else
+        {
+            out << "unknown benchmark " << name << ", available: "
+                << Benchmark::names().join(QStringLiteral(", ")) << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void Benchmark::restart(QTextStream& out)
+{
+    MineSweeper logic;
+    MineField field;
+    field.setLogic(&logic);
+
+    // average restart latency of board generation, engine reset and scene update
+    auto measure = [&](const QList<QSize>& sizes, int rounds)
+    {
+        qint64 generate = 0;
+        qint64 apply = 0;
+        qint64 scene = 0;
+        QElapsedTimer timer;
+        for(int i=0;i<rounds;++i)
+        {
+            QSize size = sizes.at(i % sizes.size());
+
+            timer.start();
+            auto board = BoardGenerator::generate(Grid(size.width(), size.height()),
+                                                  size.width() * size.height() / 5, i);
+            generate += timer.nsecsElapsed();
+
+            timer.start();
+            logic.startGame(board);
+            apply += timer.nsecsElapsed();
+
+            timer.start();
+            field.started();
+            scene += timer.nsecsElapsed();
+        }
+        QStringList names;
+        Q_FOREACH(auto size, sizes)
+            names << QStringLiteral("%1x%2").arg(size.width()).arg(size.height());
+        out << qSetFieldWidth(24) << left << names.join(QStringLiteral("<->"))
+            << qSetFieldWidth(0)
+            << "generate " << generate / rounds / 1000.0 << " us, "
+            << "engine " << apply / rounds / 1000.0 << " us, "
+            << "scene " << scene / rounds / 1000.0 << " us" << endl;
+    };
+
+    out << "restart latency" << endl;
+    QList<QSize> sizes = QList<QSize>() << QSize(10, 10) << QSize(16, 16) << QSize(30, 16)
+                                        << QSize(100, 100) << QSize(300, 300);
+    Q_FOREACH(auto size, sizes)
+    {
+        measure(QList<QSize>() << size, 1);     // warm up
+        measure(QList<QSize>() << size, size.width() * size.height() > 10000 ? 10 : 200);
+    }
+    measure(QList<QSize>() << QSize(16, 16) << QSize(30, 16), 200);
+    measure(QList<QSize>() << QSize(100, 100) << QSize(300, 300), 10);
+}
+
+void Benchmark::click(QTextStream& out)
+{
+    MineSweeper logic;
+
+    // press, click and release a tile like the mouse does
+    auto press = [&logic](const QPoint& pos, Qt::MouseButton button)
+    {
+        logic.setPressed(pos, button, true);
+        logic.click(pos, button);
+        logic.setPressed(pos, button, false);
+    };
+
+    out << "click cost" << endl;
+    QList<QSize> sizes = QList<QSize>() << QSize(30, 16) << QSize(100, 100) << QSize(500, 500);
+    QList<QPair<Topology, QString> > topologies;
+    topologies << qMakePair(Topology::Square, QStringLiteral("square"))
+               << qMakePair(Topology::Torus, QStringLiteral("torus"))
+               << qMakePair(Topology::Hexagonal, QStringLiteral("hexagonal"));
+    for(int t=0;t<topologies.size();++t)
+    {
+        Q_FOREACH(auto size, sizes)
+        {
+            int count = size.width() * size.height();
+            int rounds = qMax(1, 1000000 / count);
+            qint64 time[4] = {0, 0, 0, 0};  // flag, uncover, chord, hover
+            qint64 clicks[4] = {0, 0, 0, 0};
+            std::mt19937 random(1);
+            QElapsedTimer timer;
+            for(int round=0;round<rounds;++round)
+            {
+                Grid grid(size.width(), size.height(), 1, topologies.at(t).first);
+                logic.startGame(BoardGenerator::generate(grid, count * 20 / 100, round));
+                Cell* cells = logic.getCells();
+                QVector<QPoint> order;
+                for(int r=0;r<size.height();++r)
+                    for(int c=0;c<size.width();++c)
+                        order << QPoint(c, r);
+                std::shuffle(order.begin(), order.end(), random);
+
+                // flag all mines, uncover the remaining tiles, then chord every number
+                for(int pass=0;pass<3;++pass)
+                {
+                    Q_FOREACH(auto pos, order)
+                    {
+                        const Cell& cell = cells[grid.index(pos)];
+                        Qt::MouseButton button = Qt::NoButton;
+                        if((pass == 0) && cell.isMine)
+                            button = Qt::RightButton;
+                        else if((pass == 1) && (cell.state == Tile::Cover))
+                            button = Qt::LeftButton;
+                        else if((pass == 2) && (cell.state == Tile::Uncover))
+                            button = Qt::MidButton;
+                        if(button == Qt::NoButton)
+                            continue;
+
+                        timer.start();
+                        press(pos, button);
+                        time[pass] += timer.nsecsElapsed();
+                        ++clicks[pass];
+                    }
+                }
+
+                timer.start();
+                Q_FOREACH(auto pos, order)
+                    logic.moveHover(pos);
+                logic.setPressed(order.last(), Qt::MidButton, false);
+                time[3] += timer.nsecsElapsed();
+                clicks[3] += order.size();
+            }
+
+            const char* names[4] = {"flag", "uncover", "chord", "hover"};
+            out << topologies.at(t).second << " " << size.width() << "x" << size.height();
+            for(int i=0;i<4;++i)
+                out << "  " << names[i] << " " << time[i] / qMax<qint64>(1, clicks[i]) << " ns";
+            out << endl;
+        }
+    }
+}
+
+void Benchmark::analyze(QTextStream& out)
+{
+    // opening labels, then 3BV and the click estimate read from them, for
+    // expert density boards. The generator runs both on every board
+    out << "analyze time, " << QThread::idealThreadCount() << " threads" << endl;
+    QList<QSize> sizes = QList<QSize>() << QSize(30, 16) << QSize(1000, 1000) << QSize(10000, 10000);
+    Q_FOREACH(auto size, sizes)
+    {
+        Grid grid(size.width(), size.height());
+        auto generated = BoardGenerator::generate(grid, grid.count() * 20 / 100, 1);
+        Board board = *generated;
+        int rounds = qMax(1, 1000000 / grid.count());
+
+        QElapsedTimer timer;
+        qint64 label = 0;
+        qint64 analyze = 0;
+        BoardStatistics statistics;
+        for(int round=0;round<rounds;++round)
+        {
+            timer.start();
+            BoardAnalyzer::labelOpenings(board);
+            label += timer.nsecsElapsed();
+            timer.start();
+            statistics = BoardAnalyzer::analyze(board);
+            analyze += timer.nsecsElapsed();
+        }
+
+        out << size.width() << "x" << size.height()
+            << "  3BV " << statistics.bbbv
+            << "  openings " << statistics.openings
+            << "  isolated " << statistics.isolated
+            << "  optimal " << statistics.optimal
+            << "  label " << label / rounds / 1000 << " us"
+            << "  analyze " << analyze / rounds / 1000 << " us"
+            << "  total " << (label + analyze) / rounds / 1000 << " us" << endl;
+    }
+}
+
+void Benchmark::latency(QTextStream& out)
+{
+    MineSweeper logic;
+    MineField field;
+    field.setLogic(&logic);
+
+    // deliver a synthesized mouse event on a tile and wait until the view
+    // painted it. The cursor is left alone, it does not move offscreen
+    auto send = [&](QEvent::Type type, const QPoint& pos, Qt::MouseButton button)
+    {
+        qint64 painted = field.getLatency(button).count();
+        QMouseEvent event(type, pos, button,
+                          (type == QEvent::MouseButtonPress) ? button : Qt::NoButton,
+                          Qt::NoModifier);
+        QApplication::sendEvent(field.viewport(), &event);
+
+        QElapsedTimer timeout;
+        timeout.start();
+        while((field.getLatency(button).count() == painted) && (timeout.elapsed() < 1000))
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+    };
+
+    out << "input to display latency" << endl;
+    QList<QPair<QSize, int> > boards;
+    boards << qMakePair(QSize(10, 10), 10)
+           << qMakePair(QSize(16, 16), 40)
+           << qMakePair(QSize(30, 16), 99)
+           << qMakePair(QSize(100, 100), 2000)
+           << qMakePair(QSize(500, 500), 50000);
+    const int clicks = 200;
+    std::mt19937 random(1);
+    for(int b=0;b<boards.size();++b)
+    {
+        QSize size = boards.at(b).first;
+        Grid grid(size.width(), size.height());
+
+        // keep the window within an ordinary screen
+        field.setTileSize(qMin<qreal>(32, 1600.0 / qMax(size.width(), size.height())));
+        field.init();
+        field.clearLatency();
+
+        int game = 0;
+        auto start = [&]()
+        {
+            logic.startGame(BoardGenerator::generate(grid, boards.at(b).second, game++));
+            field.started();
+            field.show();
+            QCoreApplication::processEvents();
+        };
+        start();
+
+        // random tile in the given state, restarts the game when there is none
+        auto pick = [&](Tile::State state, int mine)
+        {
+            auto tiles = field.getTiles();
+            for(int attempt=0;attempt<2;++attempt)
+            {
+                QVector<Tile*> candidates;
+                Q_FOREACH(auto row, tiles)
+                {
+                    Q_FOREACH(auto tile, row)
+                    {
+                        if((tile->state() == state)
+                           && ((mine < 0) || (tile->isMine() == (mine > 0)))
+                           && ((state != Tile::Uncover) || (tile->surroundingMines() > 0)))
+                            candidates << tile.data();
+                    }
+                }
+                if(!candidates.isEmpty())
+                {
+                    Tile* tile = candidates.at(random() % candidates.size());
+                    QPointF center = tile->pos() + QPointF(tile->size(), tile->size()) / 2;
+                    return field.mapFromScene(center);
+                }
+                start();
+                tiles = field.getTiles();
+            }
+            return QPoint();
+        };
+
+        // flag mines, uncover safe tiles, then chord the uncovered numbers
+        QList<QPair<Qt::MouseButton, QPair<Tile::State, int> > > phases;
+        phases << qMakePair(Qt::RightButton, qMakePair(Tile::Cover, 1))
+               << qMakePair(Qt::LeftButton, qMakePair(Tile::Cover, 0))
+               << qMakePair(Qt::MidButton, qMakePair(Tile::Uncover, 0));
+        for(int p=0;p<phases.size();++p)
+        {
+            Qt::MouseButton button = phases.at(p).first;
+            for(int i=0;i<clicks;++i)
+            {
+                if(logic.getState() != MineSweeper::State::Running)
+                    start();
+                QPoint pos = pick(phases.at(p).second.first, phases.at(p).second.second);
+                send(QEvent::MouseButtonPress, pos, button);
+                send(QEvent::MouseButtonRelease, pos, button);
+            }
+        }
+
+        out << size.width() << "x" << size.height() << " " << boards.at(b).second << " mines" << endl;
+        const char* names[3] = {"left", "middle", "right"};
+        Qt::MouseButton buttons[3] = {Qt::LeftButton, Qt::MidButton, Qt::RightButton};
+        for(int i=0;i<3;++i)
+            out << "  " << qSetFieldWidth(8) << left << names[i] << qSetFieldWidth(0)
+                << field.getLatency(buttons[i]).summary() << endl;
+    }
+
+    field.hide();
+}
+
+void Benchmark::render(QTextStream& out)
+{
+    MineSweeper logic;
+    MineField field;
+    field.setLogic(&logic);
+
+    // set every tile of the board to the look of a visual state
+    enum Look {Covered = 0, Flagged, Uncovered, Finished, LookCount};
+    const char* looks[LookCount] = {"covered", "flagged", "uncovered", "finished"};
+    auto prepare = [&](const Grid& grid, Look look)
+    {
+        logic.startGame(BoardGenerator::generate(grid, grid.count() / 5, 1));
+        field.started();
+        int mine = -1;
+        Q_FOREACH(auto row, field.getTiles())
+        {
+            Q_FOREACH(auto tile, row)
+            {
+                if(tile->isMine())
+                    mine = grid.index(tile->index());
+                else if(look == Flagged)
+                    tile->setState(Tile::Flag);
+                else if(look == Uncovered)
+                    tile->setState(Tile::Uncover);
+            }
+        }
+
+        // losing the game draws the covered mines as well
+        if((look == Finished) && (mine >= 0))
+            logic.play(mine, Qt::LeftButton);
+    };
+
+    out << "render cost" << endl;
+    QList<QSize> sizes = QList<QSize>() << QSize(10, 10) << QSize(30, 16)
+                                        << QSize(100, 100) << QSize(300, 300);
+    QList<qreal> tileSizes = QList<qreal>() << 16 << 32 << 48;
+    Q_FOREACH(auto size, sizes)
+    {
+        Q_FOREACH(qreal pixels, tileSizes)
+        {
+            // keep the image below 100MB
+            if(qMax(size.width(), size.height()) * pixels > 5000)
+                continue;
+
+            field.setTileSize(pixels);
+            field.init();
+            Grid grid(size.width(), size.height());
+            int tiles = grid.count();
+            int rounds = qMax(3, 2000000 / tiles);
+
+            out << size.width() << "x" << size.height() << " tile " << pixels;
+            for(int l=0;l<LookCount;++l)
+            {
+                prepare(grid, static_cast<Look>(l));
+                QImage image(field.size(), QImage::Format_ARGB32_Premultiplied);
+                field.render(&image);   // warm up
+
+                QElapsedTimer timer;
+                timer.start();
+                for(int round=0;round<rounds;++round)
+                    field.render(&image);
+                qint64 frame = timer.nsecsElapsed() / rounds;
+
+                out << "  " << looks[l] << " " << frame / tiles << " ns/tile "
+                    << QString::number(1e9 / qMax<qint64>(1, frame), 'f', 1) << " fps";
+            }
+            out << endl;
+        }
+    }
+}
+
+void Benchmark::threads(QTextStream& out)
+{
+    // every worker owns its engine and plays expert games on its own thread,
+    // uncovering the safe tiles in random order until the game is won
+    auto play = [](int games, quint32 seed)
+    {
+        MineSweeper logic;
+        Grid grid(30, 16);
+        std::mt19937 random(seed);
+        QVector<int> order(grid.count());
+        std::iota(order.begin(), order.end(), 0);
+        for(int game=0;game<games;++game)
+        {
+            logic.startGame(BoardGenerator::generate(grid, 99, random()));
+            const Cell* cells = logic.getCells();
+            std::shuffle(order.begin(), order.end(), random);
+            Q_FOREACH(int index, order)
+            {
+                if(logic.getState() != MineSweeper::State::Running)
+                    break;
+                if(!cells[index].isMine && (cells[index].state == Tile::Cover))
+                    logic.play(index, Qt::LeftButton);
+            }
+        }
+    };
+
+    out << "parallel games, expert 30x16" << endl;
+    QList<int> counts;
+    int ideal = QThread::idealThreadCount();
+    for(int threads=1;threads<ideal;threads*=2)
+        counts << threads;
+    counts << ideal;
+
+    const int games = 2000;     // per thread
+    play(games / 10, 0);        // warm up
+    qreal single = 0;
+    Q_FOREACH(int threads, counts)
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        QElapsedTimer timer;
+        timer.start();
+        QList<QFuture<void> > futures;
+        for(int t=0;t<threads;++t)
+            futures << QtConcurrent::run(&pool, [=]() { play(games, t + 1); });
+        Q_FOREACH(auto future, futures)
+            future.waitForFinished();
+        qreal rate = threads * games * 1e9 / qMax<qint64>(1, timer.nsecsElapsed());
+        if(threads == 1)
+            single = rate;
+
+        out << qSetFieldWidth(4) << right << threads << qSetFieldWidth(0) << " threads  "
+            << qRound(rate) << " games/s  speedup "
+            << QString::number(rate / single, 'f', 2) << endl;
+    }
+}
+
+void Benchmark::batch(QTextStream& out)
+{
+    // lockstep steps of expert boards, every board uncovers a random tile.
+    // Finished boards restart inside the step, so generation is included
+    out << "batch environment, expert 30x16" << endl;
+    Grid grid(30, 16);
+    QList<int> counts = QList<int>() << 1 << 64 << 1024 << 8192;
+    Q_FOREACH(int count, counts)
+    {
+        BatchEnvironment environment(count, grid, 99, 1);
+        QVector<BatchEnvironment::Action> actions(count);
+        QVector<float> rewards(count);
+        QVector<quint8> terminals(count);
+        QVector<quint8> observations(count * grid.count());
+        environment.reset(observations.data());
+
+        std::mt19937 random(1);
+        const int steps = qMax(10, 200000 / count);
+        qint64 finished = 0;
+        QElapsedTimer timer;
+        qint64 time = 0;
+        for(int s=0;s<steps;++s)
+        {
+            for(int i=0;i<count;++i)
+                actions[i] = BatchEnvironment::Action{static_cast<int>(random() % grid.count()),
+                                                      Qt::LeftButton};
+            timer.start();
+            environment.step(actions.constData(), rewards.data(), terminals.data(),
+                             observations.data());
+            time += timer.nsecsElapsed();
+            for(int i=0;i<count;++i)
+                finished += terminals.at(i);
+        }
+
+        out << qSetFieldWidth(5) << right << count << qSetFieldWidth(0) << " boards  "
+            << time / steps / 1000 << " us/step  "
+            << qRound64(1e9 * steps * count / qMax<qint64>(1, time)) << " board steps/s  "
+            << finished << " games finished" << endl;
+    }
+}
+
+void Benchmark::bot(QTextStream& out)
+{
+    // a client thread sends pipelined right clicks to a local bot server, the
+    // game never ends so the protocol and the socket dominate
+    out << "bot protocol, expert 30x16, right clicks" << endl;
+    const QString name = QStringLiteral("MineSweeperBenchmark-%1")
+                         .arg(QCoreApplication::applicationPid());
+    BotServer server;
+    if(!server.listen(name))
+    {
+        out << server.errorString() << endl;
+        return;
+    }
+
+    QStringList results;
+    QFuture<void> client = QtConcurrent::run([&name, &results]()
+    {
+        QLocalSocket socket;
+        socket.connectToServer(name);
+        if(!socket.waitForConnected())
+            return;
+
+        // consumes replies until count have arrived
+        auto receive = [&socket](int count)
+        {
+            while(count > 0)
+            {
+                while(socket.bytesAvailable() < 5)
+                    socket.waitForReadyRead(-1);
+                char header[5];
+                socket.peek(header, sizeof(header));
+                qint64 size = 5 + qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(header + 1));
+                while(socket.bytesAvailable() < size)
+                    socket.waitForReadyRead(-1);
+                socket.read(size);
+                --count;
+            }
+        };
+
+        QByteArray request(1 + 13, 0);
+        request[0] = static_cast<char>(BotServer::NewGame);
+        qToLittleEndian<quint16>(30, reinterpret_cast<uchar*>(request.data() + 1));
+        qToLittleEndian<quint16>(16, reinterpret_cast<uchar*>(request.data() + 3));
+        qToLittleEndian<quint32>(99, reinterpret_cast<uchar*>(request.data() + 5));
+        qToLittleEndian<quint32>(1, reinterpret_cast<uchar*>(request.data() + 9));
+        socket.write(request);
+        receive(1);
+
+        std::mt19937 random(1);
+        QList<int> pipelines = QList<int>() << 1 << 16 << 256 << 4096;
+        Q_FOREACH(int pipeline, pipelines)
+        {
+            const int moves = 200000;
+            QByteArray batch(pipeline * 6, 0);
+            QElapsedTimer timer;
+            timer.start();
+            for(int sent=0;sent<moves;sent+=pipeline)
+            {
+                for(int i=0;i<pipeline;++i)
+                {
+                    char* move = batch.data() + i * 6;
+                    move[0] = static_cast<char>(BotServer::Move);
+                    qToLittleEndian<quint32>(random() % (30 * 16), reinterpret_cast<uchar*>(move + 1));
+                    move[5] = static_cast<char>(Qt::RightButton);
+                }
+                socket.write(batch);
+                socket.flush();
+                receive(pipeline);
+            }
+            qint64 time = timer.nsecsElapsed();
+            results << QStringLiteral("%1 pipelined  %2 moves/s")
+                       .arg(pipeline, 5)
+                       .arg(qRound64(1e9 * moves / qMax<qint64>(1, time)));
+        }
+    });
+
+    // the server runs on this thread's event loop
+    QEventLoop loop;
+    QFutureWatcher<void> watcher;
+    QObject::connect(&watcher, &QFutureWatcher<void>::finished,
+                     &loop, &QEventLoop::quit);
+    watcher.setFuture(client);
+    loop.exec();
+
+    Q_FOREACH(auto result, results)
+        out << result << endl;
+}
+
+void Benchmark::frontier(QTextStream& out)
+{
+    // random safe clicks and flags, the incremental update per click against
+    // rebuilding the frontier from all tiles. Small boards check every click
+    out << "frontier, 20% mines" << endl;
+    QList<QSize> sizes = QList<QSize>() << QSize(30, 16) << QSize(100, 100) << QSize(1000, 1000);
+    Q_FOREACH(auto size, sizes)
+    {
+        MineSweeper logic;
+        Grid grid(size.width(), size.height());
+        int count = grid.count();
+        Arena arena;
+        std::mt19937 random(1);
+        QElapsedTimer timer;
+        qint64 incremental = 0;
+        qint64 rescan = 0;
+        qint64 clicks = 0;
+        int rescans = 0;
+        bool consistent = true;
+        for(int round=0;round<qMax(1, 100000 / count);++round)
+        {
+            logic.startGame(BoardGenerator::generate(grid, count * 20 / 100, round));
+            const Cell* cells = logic.getCells();
+            arena.release();
+            Frontier shadow;
+            shadow.reset(grid, arena);
+            for(int c=0;(c<count / 4) && (logic.getState() == MineSweeper::State::Running);++c)
+            {
+                int index = random() % count;
+                logic.play(index, cells[index].isMine?Qt::RightButton:Qt::LeftButton);
+
+                timer.start();
+                shadow.update(cells, logic.getChanged());
+                incremental += timer.nsecsElapsed();
+                ++clicks;
+                if(count <= 10000)
+                    consistent = consistent && logic.getFrontier().check(cells);
+
+                // a full rebuild is far slower, sample it
+                if(c % 64 != 0)
+                    continue;
+                timer.start();
+                int covered = 0;
+                for(int i=0;i<count;++i)
+                {
+                    if(cells[i].state != Tile::Uncover || cells[i].surroundingMines == 0)
+                        continue;
+                    grid.forEachNeighbour(i, [cells, &covered](int neighbour)
+                    {
+                        if((cells[neighbour].state == Tile::Cover)
+                           || (cells[neighbour].state == Tile::Tag))
+                            ++covered;
+                    });
+                }
+                rescan += timer.nsecsElapsed();
+                ++rescans;
+                consistent = consistent && ((covered > 0) || shadow.getCovered().isEmpty());
+            }
+            consistent = consistent && shadow.check(cells) && logic.getFrontier().check(cells);
+        }
+
+        out << size.width() << "x" << size.height()
+            << "  incremental " << incremental / qMax<qint64>(1, clicks) << " ns/click"
+            << "  rescan " << rescan / qMax(1, rescans) << " ns"
+            << "  " << (consistent?"consistent":"INCONSISTENT") << endl;
+    }
+}
+
+void Benchmark::solver(QTextStream& out)
+{
+    // games are opened on a zero tile, then played with the deterministic
+    // moves only until a guess would be needed. Both solvers see the same
+    // snapshots, their results are compared
+    out << "solver, deterministic moves per game" << endl;
+    QList<QPair<QSize, int> > levels;
+    levels << qMakePair(QSize(30, 16), 99)
+           << qMakePair(QSize(256, 256), 256 * 256 * 16 / 100);
+    for(int l=0;l<levels.size();++l)
+    {
+        QSize size = levels.at(l).first;
+        Grid grid(size.width(), size.height());
+        MineSweeper logic;
+        BitboardSolver solver;
+        const int games = qMax(4, 2000000 / grid.count());
+        qint64 bitboard = 0;
+        qint64 naive = 0;
+        int solved = 0;
+        bool agree = true;
+        QElapsedTimer timer;
+        for(int game=0;game<games;++game)
+        {
+            auto board = BoardGenerator::generate(grid, levels.at(l).second, game);
+            logic.startGame(board);
+            int zero = board->surroundingMines.indexOf(0);
+            while((zero >= 0) && board->isMine.at(zero))
+                zero = board->surroundingMines.indexOf(0, zero + 1);
+            if(zero >= 0)
+                logic.play(zero, Qt::LeftButton);
+
+            while(logic.getState() == MineSweeper::State::Running)
+            {
+                auto snapshot = logic.snapshot();
+                timer.start();
+                solver.load(*snapshot);
+                BitboardSolver::Result result = solver.solve();
+                bitboard += timer.nsecsElapsed();
+
+                timer.start();
+                BitboardSolver::Result reference = naiveSolve(*snapshot);
+                naive += timer.nsecsElapsed();
+                agree = agree && (result.safe == reference.safe) && (result.mines == reference.mines);
+
+                if(result.safe.isEmpty() && result.mines.isEmpty())
+                    break;
+                Q_FOREACH(int cell, result.mines)
+                    logic.play(cell, Qt::RightButton);
+                Q_FOREACH(int cell, result.safe)
+                    logic.play(cell, Qt::LeftButton);
+            }
+            solved += (logic.getState() == MineSweeper::State::Success);
+        }
+
+        out << size.width() << "x" << size.height()
+            << "  bitboard " << bitboard / games / 1000 << " us/game"
+            << "  naive " << naive / games / 1000 << " us/game"
+            << "  solved " << solved << "/" << games
+            << "  " << (agree?"agree":"DISAGREE") << endl;
+    }
+}
+
+void Benchmark::patterns(QTextStream& out)
+{
+    // expert games opened on a zero tile. The pattern table goes first, the
+    // bitboard solver only runs when it finds nothing. Games the bitboard
+    // solver alone finishes are counted on the same boards
+    out << "patterns, expert 30x16" << endl;
+    Grid grid(30, 16);
+    MineSweeper logic;
+    PatternSolver patterns;
+    BitboardSolver solver;
+    const int games = 2000;
+    qint64 lookup = 0;
+    qint64 windows = 0;
+    int patternMoves = 0;
+    int solverMoves = 0;
+    int solved[2] = {0, 0};     // with patterns, bitboard solver only
+    QElapsedTimer timer;
+    for(int pass=0;pass<2;++pass)
+    {
+        for(int game=0;game<games;++game)
+        {
+            auto board = BoardGenerator::generate(grid, 99, game);
+            logic.startGame(board);
+            int zero = board->surroundingMines.indexOf(0);
+            while((zero >= 0) && board->isMine.at(zero))
+                zero = board->surroundingMines.indexOf(0, zero + 1);
+            if(zero >= 0)
+                logic.play(zero, Qt::LeftButton);
+
+            while(logic.getState() == MineSweeper::State::Running)
+            {
+                QVector<int> safe;
+                QVector<int> mines;
+                if(pass == 0)
+                {
+                    timer.start();
+                    PatternSolver::Result result = patterns.solve(logic.observe());
+                    lookup += timer.nsecsElapsed();
+                    windows += patterns.getWindows();
+                    safe = result.safe;
+                    mines = result.mines;
+                    patternMoves += safe.size() + mines.size();
+                }
+                if(safe.isEmpty() && mines.isEmpty())
+                {
+                    solver.load(*logic.snapshot());
+                    BitboardSolver::Result result = solver.solve();
+                    safe = result.safe;
+                    mines = result.mines;
+                    if(pass == 0)
+                        solverMoves += safe.size() + mines.size();
+                }
+                if(safe.isEmpty() && mines.isEmpty())
+                    break;
+                Q_FOREACH(int cell, mines)
+                    logic.play(cell, Qt::RightButton);
+                Q_FOREACH(int cell, safe)
+                    logic.play(cell, Qt::LeftButton);
+            }
+            solved[pass] += (logic.getState() == MineSweeper::State::Success);
+        }
+    }
+
+    out << "  " << qRound64(1e9 * windows / qMax<qint64>(1, lookup)) << " windows/s  "
+        << lookup / qMax<qint64>(1, windows) << " ns/window" << endl
+        << "  moves by patterns " << patternMoves << ", by solver " << solverMoves << endl
+        << "  solved " << solved[0] << "/" << games << " with patterns, "
+        << solved[1] << "/" << games << " without" << endl;
+}
+
+void Benchmark::chord(QTextStream& out)
+{
+    // every mine is flagged first, then one safe click lets the auto chord
+    // cascade open everything reachable
+    out << "auto chord cascade, 15% mines" << endl;
+    QList<QSize> sizes = QList<QSize>() << QSize(30, 16) << QSize(256, 256) << QSize(1000, 1000);
+    Q_FOREACH(auto size, sizes)
+    {
+        Grid grid(size.width(), size.height());
+        MineSweeper logic;
+        logic.setAutoChord(true);
+        const int rounds = qMax(1, 1000000 / grid.count());
+        qint64 time = 0;
+        qint64 opened = 0;
+        QElapsedTimer timer;
+        for(int round=0;round<rounds;++round)
+        {
+            auto board = BoardGenerator::generate(grid, grid.count() * 15 / 100, round);
+            logic.startGame(board);
+            for(int i=0;i<grid.count();++i)
+            {
+                if(board->isMine.at(i))
+                    logic.play(i, Qt::RightButton);
+            }
+
+            int safe = board->isMine.indexOf(false);
+            timer.start();
+            logic.play(safe, Qt::LeftButton);
+            time += timer.nsecsElapsed();
+            opened += logic.getChanged().size();
+        }
+
+        out << size.width() << "x" << size.height()
+            << "  " << time / rounds / 1000 << " us/cascade  "
+            << opened / rounds << " tiles  "
+            << time / qMax<qint64>(1, opened) << " ns/tile" << endl;
+    }
+}
+
+void Benchmark::undo(QTextStream& out)
+{
+    // one click on a zero tile of a sparse board opens a huge area, which
+    // is then undone and redone
+    out << "undo and redo of an opening, 1% mines" << endl;
+    QList<QSize> sizes = QList<QSize>() << QSize(100, 100) << QSize(1000, 1000) << QSize(3000, 3000);
+    Q_FOREACH(auto size, sizes)
+    {
+        Grid grid(size.width(), size.height());
+        MineSweeper logic;
+        auto board = BoardGenerator::generate(grid, grid.count() / 100, 1);
+        logic.startGame(board);
+        int zero = 0;
+        while(board->isMine.at(zero) || (board->surroundingMines.at(zero) != 0))
+            ++zero;
+
+        QElapsedTimer timer;
+        timer.start();
+        logic.play(zero, Qt::LeftButton);
+        qint64 play = timer.nsecsElapsed();
+        int tiles = logic.getChanged().size();
+
+        timer.start();
+        logic.undo();
+        qint64 undo = timer.nsecsElapsed();
+        bool restored = (logic.getRemaining() == grid.count() - board->mines);
+
+        timer.start();
+        logic.redo();
+        qint64 redo = timer.nsecsElapsed();
+        restored = restored && (logic.getChanged().size() == tiles) && logic.getFrontier().check(logic.getCells());
+
+        out << size.width() << "x" << size.height() << "  " << tiles << " tiles"
+            << "  play " << play / 1000 << " us"
+            << "  undo " << undo / 1000 << " us"
+            << "  redo " << redo / 1000 << " us"
+            << "  journal " << tiles * sizeof(Journal::Delta) / 1024 << " KiB"
+            << "  " << (restored?"restored":"NOT RESTORED") << endl;
+    }
+}
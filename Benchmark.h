@@ -0,0 +1,30 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QtCore/QtCore>
+
+// Command line benchmarks, run with --benchmark <name> (offscreen works:
+// QT_QPA_PLATFORM=offscreen). Results are printed to stdout.
+class Benchmark
+{
+public:
+    static QStringList names();
+    static int run(const QStringList& names);
+
+private:
+    static void restart(QTextStream& out);
+    static void click(QTextStream& out);
+    static void analyze(QTextStream& out);
+    static void latency(QTextStream& out);
+    static void render(QTextStream& out);
+    static void threads(QTextStream& out);
+    static void batch(QTextStream& out);
+    static void bot(QTextStream& out);
+    static void frontier(QTextStream& out);
+    static void solver(QTextStream& out);
+    static void patterns(QTextStream& out);
+    static void chord(QTextStream& out);
+    static void undo(QTextStream& out);
+};
+
+#endif // BENCHMARK_H
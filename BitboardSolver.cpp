@@ -0,0 +1,242 @@
+#include "BitboardSolver.h"
+
+namespace {
+// counter += bit, for four bit-sliced 4 bit counters. 8 neighbours fit
+inline void add(quint64 counter[4], quint64 bits)
+{
+    for(int i=0;i<4;++i)
+    {
+        quint64 carry = counter[i] & bits;
+        counter[i] ^= bits;
+        bits = carry;
+    }
+}
+}
+
+bool BitboardSolver::isSupported(const Grid& grid)
+{
+    return (grid.topology == Topology::Square) && (grid.layers == 1);
+}
+
+void BitboardSolver::load(const BoardSnapshot& snapshot)
+{
+    const Grid& grid = snapshot.board->grid;
+    reset(grid, snapshot.mineCount);
+    if(!supported)
+        return;
+
+    const quint8* numbers = snapshot.board->surroundingMines.constData();
+    for(int r=0;r<rows;++r)
+    {
+        for(int c=0;c<columns;++c)
+        {
+            int index = r * columns + c;
+            Cell cell;
+            cell.state = snapshot.tileState(index);
+            cell.surroundingMines = numbers[index];
+            setTile(r, c, Observation::code(cell));
+        }
+    }
+}
+
+void BitboardSolver::load(const Grid& grid, const Observation::View& view, int mineCount)
+{
+    reset(grid, mineCount);
+    if(!supported)
+        return;
+
+    for(int r=0;r<rows;++r)
+    {
+        for(int c=0;c<columns;++c)
+            setTile(r, c, view.at(c, r));
+    }
+}
+
+void BitboardSolver::reset(const Grid& grid, int mines)
+{
+    // a torus or hexagonal board read as a rectangle gives wrong answers
+    Q_ASSERT(isSupported(grid));
+    supported = isSupported(grid);
+    columns = supported?grid.columns:0;
+    rows = supported?grid.rows:0;
+    stride = (columns + 63) / 64;
+    size = rows * stride;
+    mineCount = mines;
+    planes.fill(0, size * PlaneCount);
+}
+
+void BitboardSolver::setTile(int row, int col, quint8 code)
+{
+    int word = row * stride + col / 64;
+    quint64 bit = Q_UINT64_C(1) << (col % 64);
+    switch(code)
+    {
+    case Observation::Covered:
+    case Observation::Tagged:
+        plane(Unknown)[word] |= bit;
+        break;
+    case Observation::Flagged:
+        plane(Flagged)[word] |= bit;
+        break;
+    case Observation::Exploded:
+    case Observation::Number:   // a zero says nothing new
+        break;
+    default:
+        plane(Numbers)[word] |= bit;
+        for(int b=0;b<4;++b)
+        {
+            if(code & (1 << b))
+                plane(static_cast<Plane>(Value0 + b))[word] |= bit;
+        }
+        break;
+    }
+}
+
+BitboardSolver::Result BitboardSolver::solve()
+{
+    Result result;
+    if(!supported || (size == 0))
+        return result;
+
+    // found mines act as flags, which satisfies more numbers
+    quint64* unknown = plane(Unknown);
+    quint64* flagged = plane(Flagged);
+    quint64* safe = plane(Safe);
+    quint64* mines = plane(Mines);
+    for(;;)
+    {
+        evaluate();
+        quint64 found = 0;
+        for(int r=0;r<rows;++r)
+        {
+            for(int w=0;w<stride;++w)
+            {
+                int word = r * stride + w;
+                quint64 mine = around(Full, r, w) & unknown[word];
+                safe[word] |= around(Satisfied, r, w) & unknown[word] & ~mine;
+                unknown[word] &= ~mine;
+                flagged[word] |= mine;
+                mines[word] |= mine;
+                found |= mine;
+            }
+        }
+        if(!found)
+            break;
+    }
+
+    // the mine count decides the rest when it is 0, or all remaining are mines
+    int left = mineCount;
+    int open = 0;
+    for(int i=0;i<size;++i)
+    {
+        left -= qPopulationCount(mines[i]);
+        open += qPopulationCount(unknown[i] & ~safe[i]);
+    }
+    if((open > 0) && ((left == 0) || (left == open)))
+    {
+        for(int i=0;i<size;++i)
+        {
+            quint64 rest = unknown[i] & ~safe[i];
+            if(left == 0)
+                safe[i] |= rest;
+            else
+                mines[i] |= rest;
+        }
+    }
+
+    result.safe = cells(safe, rows, stride, columns);
+    result.mines = cells(mines, rows, stride, columns);
+    return result;
+}
+
+quint64 BitboardSolver::around(Plane p, int row, int word) const
+{
+    // bit c of a line shifted left holds column c - 1, shifted right c + 1.
+    // Numbers and covered tiles never overlap, the cell itself is left out
+    const quint64* bits = planes.constData() + p * size;
+    quint64 result = 0;
+    for(int r=qMax(0, row - 1);r<=qMin(rows - 1, row + 1);++r)
+    {
+        const quint64* line = bits + r * stride;
+        quint64 mid = line[word];
+        quint64 prev = (word > 0)?line[word - 1]:0;
+        quint64 next = (word + 1 < stride)?line[word + 1]:0;
+        result |= (mid << 1) | (prev >> 63) | (mid >> 1) | (next << 63);
+        if(r != row)
+            result |= mid;
+    }
+    return result;
+}
+
+void BitboardSolver::evaluate()
+{
+    const quint64* unknown = plane(Unknown);
+    const quint64* flagged = plane(Flagged);
+    const quint64* numbers = plane(Numbers);
+    const quint64* value[4] = {plane(Value0), plane(Value1), plane(Value2), plane(Value3)};
+    quint64* satisfied = plane(Satisfied);
+    quint64* full = plane(Full);
+    for(int r=0;r<rows;++r)
+    {
+        for(int w=0;w<stride;++w)
+        {
+            // flags and covered tiles around every cell of the word
+            quint64 flags[4] = {0, 0, 0, 0};
+            quint64 covered[4] = {0, 0, 0, 0};
+            for(int y=qMax(0, r - 1);y<=qMin(rows - 1, r + 1);++y)
+            {
+                int word = y * stride + w;
+                quint64 shifted[3][2];
+                for(int k=0;k<2;++k)
+                {
+                    const quint64* line = (k == 0)?flagged:unknown;
+                    quint64 mid = line[word];
+                    quint64 prev = (w > 0)?line[word - 1]:0;
+                    quint64 next = (w + 1 < stride)?line[word + 1]:0;
+                    shifted[0][k] = (mid << 1) | (prev >> 63);
+                    shifted[1][k] = (mid >> 1) | (next << 63);
+                    shifted[2][k] = (y != r)?mid:0;
+                }
+                for(int s=0;s<3;++s)
+                {
+                    add(flags, shifted[s][0]);
+                    add(covered, shifted[s][0] | shifted[s][1]);
+                }
+            }
+
+            int word = r * stride + w;
+            quint64 flagsEqual = ~Q_UINT64_C(0);
+            quint64 coveredEqual = ~Q_UINT64_C(0);
+            for(int b=0;b<4;++b)
+            {
+                flagsEqual &= ~(flags[b] ^ value[b][word]);
+                coveredEqual &= ~(covered[b] ^ value[b][word]);
+            }
+            satisfied[word] = numbers[word] & flagsEqual;
+            full[word] = numbers[word] & coveredEqual;
+        }
+    }
+}
+
+QVector<int> BitboardSolver::cells(const quint64* bits, int rows, int stride, int columns)
+{
+    int count = 0;
+    for(int i=0;i<rows * stride;++i)
+        count += qPopulationCount(bits[i]);
+
+    QVector<int> result;
+    result.reserve(count);
+    for(int r=0;r<rows;++r)
+    {
+        for(int w=0;w<stride;++w)
+        {
+            quint64 word = bits[r * stride + w];
+            while(word)
+            {
+                result << r * columns + w * 64 + static_cast<int>(qCountTrailingZeroBits(word));
+                word &= word - 1;
+            }
+        }
+    }
+    return result;
+}
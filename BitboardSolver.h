@@ -0,0 +1,63 @@
+#ifndef BITBOARDSOLVER_H
+#define BITBOARDSOLVER_H
+
+#include <QtCore/QtCore>
+#include "BoardSnapshot.h"
+#include "Observation.h"
+
+// Deterministic moves of a square board from what the player sees. Every
+// line is stored as 64 bit words, neighbour counts of whole words are added
+// bit-sliced from shifted lines and compared with the numbers at once.
+// Player flags are trusted. Other topologies are not supported, solve()
+// finds nothing on them
+class BitboardSolver
+{
+public:
+    struct Result
+    {
+        QVector<int> safe;      // covered cells without mine, ascending
+        QVector<int> mines;     // covered unflagged cells with mine, ascending
+    };
+
+    static bool isSupported(const Grid& grid);
+
+    // reads the visible tiles and numbers of a position
+    void load(const BoardSnapshot& snapshot);
+    // same from Observation codes, mineCount is mines minus flags
+    void load(const Grid& grid, const Observation::View& view, int mineCount);
+    // single numbers repeated until no mine is found, then the mine count
+    Result solve();
+
+private:
+    enum Plane {
+        Unknown = 0,    // covered or tagged
+        Flagged,
+        Numbers,        // uncovered with surrounding mines
+        Value0,         // bits of the numbers, bit-sliced
+        Value1,
+        Value2,
+        Value3,
+        Satisfied,      // numbers with as many flags around
+        Full,           // numbers with as many covered tiles around
+        Safe,
+        Mines,
+        PlaneCount
+    };
+
+    quint64* plane(Plane p) { return planes.data() + p * size; }
+    void reset(const Grid& grid, int mines);
+    void setTile(int row, int col, quint8 code);
+    quint64 around(Plane p, int row, int word) const;
+    void evaluate();
+    static QVector<int> cells(const quint64* bits, int rows, int stride, int columns);
+
+    int columns = 0;
+    int rows = 0;
+    int stride = 0;     // words per line
+    int size = 0;       // words per plane
+    int mineCount = 0;  // mines minus flags
+    bool supported = false;
+    QVector<quint64> planes;
+};
+
+#endif // BITBOARDSOLVER_H
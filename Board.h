@@ -0,0 +1,33 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <QtCore/QtCore>
+#include "Grid.h"
+#include "BoardAnalyzer.h"
+
+// Immutable mine layout of one game, shared between the generator thread
+// and the GUI thread. Cells are indexed by grid.
+struct Board
+{
+    struct Span
+    {
+        int begin;  // first cell
+        int end;    // one past the last cell, on the same line
+    };
+
+    Grid grid;                          // dimensions and topology
+    int mines = 0;                      // mine count
+    quint32 seed = 0;                   // random seed the layout was generated from
+    QVector<bool> isMine;               // has mine
+    QVector<quint8> surroundingMines;   // surrounding mine counts
+    BoardStatistics statistics;         // 3BV and openings
+    QVector<int> opening;               // opening of zero tiles, -1 for the others
+    QVector<int> openingOffsets;        // spans of opening o start at openingOffsets[o]
+    QVector<Span> openingSpans;         // cells revealed by each opening, border numbers included
+};
+
+Q_DECLARE_TYPEINFO(Board::Span, Q_PRIMITIVE_TYPE);
+
+Q_DECLARE_METATYPE(QSharedPointer<const Board>)
+
+#endif // BOARD_H
@@ -0,0 +1,420 @@
+#include "BoardAnalyzer.h"
+#include "Board.h"
+#include <QtConcurrent/QtConcurrent>
+
+namespace {
+int find(int* parent, int i)
+{
+    // path halving
+    while(parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// root lookup without path compression, safe while other bands read the forest
+int root(const int* parent, int i)
+{
+    while(parent[i] != i)
+        i = parent[i];
+    return i;
+}
+
+// lines [begin, end) of the board labelled by one task
+struct Band
+{
+    int begin;
+    int end;
+    QVector<QPair<int, int> > seams;    // zero neighbours in an earlier band
+    int roots = 0;                      // openings rooted in this band
+    int firstLabel = 0;                 // label of the first of them
+    QVector<int> spanOpenings;          // opening of each span
+    QVector<Board::Span> spans;
+};
+
+// boards below this size are labelled on the calling thread, handing them to
+// the pool costs more than it saves and serializes games run in parallel
+const int ParallelCells = 64 * 1024;
+
+template<typename Bands, typename Function>
+void forEachBand(Bands& bands, Function function)
+{
+    if(bands.size() == 1)
+        function(bands.first());
+    else
+        QtConcurrent::blockingMap(bands, function);
+}
+
+// lines [begin, end) of the board analyzed by one task. The height is fixed,
+// so the click estimate does not depend on the number of cores
+struct Strip
+{
+    int begin;
+    int end;
+    int isolated = 0;   // numbers, until the spans take the bordering ones
+    int clicks = 0;     // chords, clicks and flags they took
+    int chorded = 0;    // isolated numbers uncovered by chords
+};
+
+const int StripLines = 64;
+
+// what the click estimate knows of a cell
+enum Mark : quint8 {
+    Zero = 0,
+    Bordering,  // uncovered number
+    Isolated,   // covered number
+    Mine,
+    Flagged
+};
+
+// calls function(i, forEachNeighbour) for the cells of lines [begin, end).
+// Planar interior cells walk their neighbours without division or bounds checks
+template<typename Function>
+void forEachCell(const Grid& grid, int begin, int end, Function&& function)
+{
+    bool planar = (grid.layers == 1) && (grid.topology != Topology::Cube);
+    for(int row=begin;row<end;++row)
+    {
+        for(int col=0;col<grid.columns;++col)
+        {
+            int i = row * grid.columns + col;
+            if(planar && grid.isInterior(col, row))
+            {
+                if(grid.topology == Topology::Hexagonal)
+                    function(i, [&](auto&& visit)
+                    {
+                        HexagonalNeighbourhood::walk<Border::Unchecked>(grid, col, row, visit);
+                    });
+                else
+                    function(i, [&](auto&& visit)
+                    {
+                        SquareNeighbourhood::walk<Border::Unchecked>(grid, col, row, visit);
+                    });
+            }
+            else
+            {
+                function(i, [&](auto&& visit)
+                {
+                    grid.forEachNeighbour(i, visit);
+                });
+            }
+        }
+    }
+}
+}
+
+BoardStatistics BoardAnalyzer::analyze(const Board& board)
+{
+    const Grid& grid = board.grid;
+    const int count = grid.count();
+    const int lines = grid.rows * grid.layers;
+    Q_ASSERT(board.opening.size() == count);
+    const bool* isMine = board.isMine.constData();
+    const quint8* surroundingMines = board.surroundingMines.constData();
+
+    // stacked layers have neighbours far away, they stay one strip
+    QVector<Strip> strips;
+    int stripLines = ((grid.layers == 1) && (count >= ParallelCells)) ? StripLines : qMax(1, lines);
+    for(int line=0;line<lines;line+=stripLines)
+    {
+        Strip strip;
+        strip.begin = line;
+        strip.end = qMin(line + stripLines, lines);
+        strips << strip;
+    }
+
+    // numbers start out isolated, the spans of the openings hold the
+    // numbers bordering them, so no neighbourhood is walked
+    QScopedArrayPointer<quint8> markArray(new quint8[count]);
+    quint8* mark = markArray.data();
+    forEachBand(strips, [=](Strip& strip)
+    {
+        for(int i=strip.begin*grid.columns;i<strip.end*grid.columns;++i)
+        {
+            mark[i] = isMine[i] ? Mine : ((surroundingMines[i] == 0) ? Zero : Isolated);
+            strip.isolated += (mark[i] == Isolated);
+        }
+    });
+    int bordering = 0;
+    for(const Board::Span& span : board.openingSpans)
+    {
+        for(int i=span.begin;i<span.end;++i)
+        {
+            bordering += (mark[i] == Isolated);
+            mark[i] = (mark[i] == Isolated) ? Bordering : mark[i];
+        }
+    }
+
+    // greedy estimate in the spirit of ZiNi: every opening is clicked
+    // first, then a number is chorded when it uncovers more isolated numbers
+    // than its missing flags and the chord cost. The rest is clicked one by
+    // one. Uncovered isolated numbers become bordering, flagged mines flagged
+    auto chord = [=](Strip& strip, int i, auto&& forEachNeighbour)
+    {
+        if((mark[i] != Bordering) && (mark[i] != Isolated))
+            return;
+
+        // numbers uncovered minus flags placed, the marks alone tell the
+        // neighbours apart without branching
+        int premium = 0;
+        forEachNeighbour([&](int neighbour)
+        {
+            premium += (mark[neighbour] == Isolated) - (mark[neighbour] == Mine);
+        });
+        if(premium <= 1)
+            return;
+
+        // an isolated number is clicked itself before it chords
+        int covered = (mark[i] == Isolated);
+        strip.clicks += covered + 1;
+        strip.chorded += covered;
+        mark[i] = Bordering;
+        forEachNeighbour([&](int neighbour)
+        {
+            if(mark[neighbour] == Isolated)
+            {
+                mark[neighbour] = Bordering;
+                ++strip.chorded;
+            }
+            else if(mark[neighbour] == Mine)
+            {
+                mark[neighbour] = Flagged;
+                ++strip.clicks;
+            }
+        });
+    };
+
+    BoardStatistics statistics;
+    for(const Strip& strip : strips)
+        statistics.isolated += strip.isolated;
+    statistics.isolated -= bordering;
+    // a chord pays off from two isolated numbers on
+    if(statistics.isolated > 1)
+    {
+        // inner lines of a strip only touch their own strip and are chorded
+        // in parallel, the first and last lines in order afterwards
+        bool single = (strips.size() == 1);
+        forEachBand(strips, [=](Strip& strip)
+        {
+            if(single)
+            {
+                forEachCell(grid, strip.begin, strip.end, [&](int i, auto&& forEachNeighbour)
+                {
+                    chord(strip, i, forEachNeighbour);
+                });
+                return;
+            }
+            forEachCell(grid, strip.begin + 1, strip.end - 1, [&](int i, auto&& forEachNeighbour)
+            {
+                chord(strip, i, forEachNeighbour);
+            });
+        });
+        if(!single)
+        {
+            for(Strip& strip : strips)
+            {
+                forEachCell(grid, strip.begin, strip.begin + 1, [&](int i, auto&& forEachNeighbour)
+                {
+                    chord(strip, i, forEachNeighbour);
+                });
+                if(strip.end - 1 > strip.begin)
+                    forEachCell(grid, strip.end - 1, strip.end, [&](int i, auto&& forEachNeighbour)
+                    {
+                        chord(strip, i, forEachNeighbour);
+                    });
+            }
+        }
+    }
+
+    int clicks = 0;
+    int chorded = 0;    // isolated numbers uncovered by chords
+    for(const Strip& strip : strips)
+    {
+        clicks += strip.clicks;
+        chorded += strip.chorded;
+    }
+    statistics.openings = board.openingOffsets.size() - 1;
+    statistics.bbbv = statistics.openings + statistics.isolated;
+    statistics.optimal = statistics.openings + clicks + statistics.isolated - chorded;
+    return statistics;
+}
+
+void BoardAnalyzer::labelOpenings(Board& board)
+{
+    const Grid& grid = board.grid;
+    const int count = grid.count();
+    const int lines = grid.rows * grid.layers;
+    const bool* isMine = board.isMine.constData();
+    const quint8* surroundingMines = board.surroundingMines.constData();
+    auto isZero = [=](int i)
+    {
+        return (surroundingMines[i] == 0) && !isMine[i];
+    };
+
+    QVector<int> forest(count);
+    int* parent = forest.data();
+    board.opening.fill(-1, count);
+    int* label = board.opening.data();
+
+    // a few bands per core balance the uneven density of zero tiles
+    QVector<Band> bands;
+    int bandCount = (count < ParallelCells)
+                    ? 1 : qBound(1, QThread::idealThreadCount() * 4, qMax(1, lines));
+    for(int b=0;b<bandCount;++b)
+    {
+        Band band;
+        band.begin = lines * b / bandCount * grid.columns;
+        band.end = lines * (b + 1) / bandCount * grid.columns;
+        bands << band;
+    }
+
+    // union-find inside every band, smaller roots survive. Edges into an
+    // earlier band are kept as seams, edges into a later one are seen from there
+    forEachBand(bands, [=](Band& band)
+    {
+        forEachCell(grid, band.begin / grid.columns, band.end / grid.columns,
+                    [&](int i, auto&& forEachNeighbour)
+        {
+            if(!isZero(i))
+                return;
+
+            int top = i;
+            parent[i] = i;
+            forEachNeighbour([&](int neighbour)
+            {
+                if((neighbour > i) || !isZero(neighbour))
+                    return;
+                if(neighbour < band.begin)
+                {
+                    band.seams << qMakePair(i, neighbour);
+                    return;
+                }
+                int other = find(parent, neighbour);
+                if(other == top)
+                    return;
+                if(other < top)
+                    std::swap(other, top);
+                parent[other] = top;
+            });
+        });
+    });
+
+    // join the bands along their seams
+    Q_FOREACH(const Band& band, bands)
+    {
+        for(const auto& seam : band.seams)
+        {
+            int a = find(parent, seam.first);
+            int b = find(parent, seam.second);
+            if(a == b)
+                continue;
+            if(a < b)
+                std::swap(a, b);
+            parent[a] = b;
+        }
+    }
+
+    // number the roots in index order
+    forEachBand(bands, [=](Band& band)
+    {
+        for(int i=band.begin;i<band.end;++i)
+            band.roots += isZero(i) && (parent[i] == i);
+    });
+    int openings = 0;
+    for(int b=0;b<bands.size();++b)
+    {
+        bands[b].firstLabel = openings;
+        openings += bands.at(b).roots;
+    }
+    forEachBand(bands, [=](Band& band)
+    {
+        int next = band.firstLabel;
+        for(int i=band.begin;i<band.end;++i)
+        {
+            if(isZero(i) && (parent[i] == i))
+                label[i] = next++;
+        }
+    });
+
+    // label the other zero tiles after their root, then collect the runs of
+    // every opening line by line. A number borders up to four openings
+    forEachBand(bands, [=](Band& band)
+    {
+        for(int i=band.begin;i<band.end;++i)
+        {
+            if(isZero(i) && (parent[i] != i))
+                label[i] = label[root(parent, i)];
+        }
+    });
+    forEachBand(bands, [=](Band& band)
+    {
+        typedef QVarLengthArray<QPair<int, int>, 8> Runs;   // opening, span
+        Runs open;
+        Runs current;
+        forEachCell(grid, band.begin / grid.columns, band.end / grid.columns,
+                    [&](int i, auto&& forEachNeighbour)
+        {
+            if(i % grid.columns == 0)
+                open.clear();
+
+            QVarLengthArray<int, 8> openings;
+            if(isZero(i))
+            {
+                openings << label[i];
+            }
+            else if(!isMine[i])
+            {
+                // zero tiles are labelled by now, the others hold -1
+                forEachNeighbour([&](int neighbour)
+                {
+                    int opening = label[neighbour];
+                    if((opening >= 0) && !openings.contains(opening))
+                        openings << opening;
+                });
+            }
+            // most cells of a dense board are far from any opening
+            if(openings.isEmpty() && open.isEmpty())
+                return;
+
+            current.clear();
+            for(int opening : openings)
+            {
+                int span = -1;
+                for(const auto& run : open)
+                {
+                    if(run.first == opening)
+                        span = run.second;
+                }
+                if(span < 0)
+                {
+                    span = band.spans.size();
+                    band.spans << Board::Span{i, i};
+                    band.spanOpenings << opening;
+                }
+                band.spans[span].end = i + 1;
+                current << qMakePair(opening, span);
+            }
+            std::swap(open, current);
+        });
+    });
+
+    // group the spans by opening
+    board.openingOffsets.fill(0, openings + 1);
+    int* offsets = board.openingOffsets.data();
+    Q_FOREACH(const Band& band, bands)
+    {
+        Q_FOREACH(int opening, band.spanOpenings)
+            ++offsets[opening + 1];
+    }
+    for(int o=0;o<openings;++o)
+        offsets[o + 1] += offsets[o];
+    QVector<int> position = board.openingOffsets;
+    board.openingSpans.resize(offsets[openings]);
+    Q_FOREACH(const Band& band, bands)
+    {
+        for(int s=0;s<band.spans.size();++s)
+            board.openingSpans[position[band.spanOpenings.at(s)]++] = band.spans.at(s);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef BOARDANALYZER_H
+#define BOARDANALYZER_H
+
+#include <QtCore/QtCore>
+
+struct Board;
+
+// Difficulty of a mine layout. 3BV is the minimum number of left clicks
+// clearing the board without flags: one per opening, plus one per number
+// not bordering any opening. Flags and chords can save some of them.
+struct BoardStatistics
+{
+    int bbbv = 0;       // 3BV
+    int openings = 0;   // connected areas of zero tiles
+    int isolated = 0;   // numbers not bordering an opening
+    int optimal = 0;    // estimated clicks with flags and chords, at most 3BV
+};
+
+class BoardAnalyzer
+{
+public:
+    // fills the opening labels and spans of the board, bands of lines are
+    // labelled in parallel and joined along their seams afterwards
+    static void labelOpenings(Board& board);
+
+    // reads the openings labelled by labelOpenings(), strips of lines are
+    // marked and chorded in parallel. Linear in the cell count
+    static BoardStatistics analyze(const Board& board);
+};
+
+#endif // BOARDANALYZER_H
@@ -0,0 +1,98 @@
+#include "BoardGenerator.h"
+#include "Grid.h"
+#include <numeric>
+#include <random>
+
+BoardGenerator::BoardGenerator(QObject* parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<Grid>("Grid");
+    qRegisterMetaType<QSharedPointer<const Board> >("QSharedPointer<const Board>");
+}
+
+QSharedPointer<const Board> BoardGenerator::generate(const Grid& grid, int mines, quint32 seed,
+                                                     const std::function<bool(int)>& progress)
+{
+    int count = grid.count();
+
+    QSharedPointer<Board> board = QSharedPointer<Board>::create();
+    board->grid = grid;
+    board->mines = qBound(0, mines, count);
+    board->seed = seed;
+    board->isMine.fill(false, count);
+    board->surroundingMines.fill(0, count);
+
+    // report progress at most every 50ms, small boards never report
+    QElapsedTimer timer;
+    timer.start();
+    qint64 reported = 0;
+    auto step = [&](qint64 percent)
+    {
+        if(!progress || (timer.elapsed() - reported < 50))
+            return true;
+        reported = timer.elapsed();
+        return progress(static_cast<int>(percent));
+    };
+
+    // place mines by a partial Fisher-Yates shuffle of cell indices
+    std::mt19937 random(seed);
+    QVector<int> cells(count);
+    std::iota(cells.begin(), cells.end(), 0);
+    for(int i=0;i<board->mines;++i)
+    {
+        int j = std::uniform_int_distribution<int>(i, count - 1)(random);
+        std::swap(cells[i], cells[j]);
+        board->isMine[cells.at(i)] = true;
+        if(((i & 0xFFF) == 0) && !step(i * Q_INT64_C(50) / board->mines))
+            return QSharedPointer<const Board>();
+    }
+
+    // count surrounding mines, one line of cells at a time
+    int lines = grid.rows * grid.layers;
+    for(int line=0;line<lines;++line)
+    {
+        int end = (line + 1) * grid.columns;
+        for(int i=line*grid.columns;i<end;++i)
+        {
+            quint8 mineCount = 0;
+            grid.forEachNeighbour(i, [&](int neighbour)
+            {
+                mineCount += (board->isMine.at(neighbour)?1:0);
+            });
+            board->surroundingMines[i] = mineCount;
+        }
+        if(!step(50 + line * Q_INT64_C(50) / lines))
+            return QSharedPointer<const Board>();
+    }
+
+    BoardAnalyzer::labelOpenings(*board);
+    board->statistics = BoardAnalyzer::analyze(*board);
+    return board;
+}
+
+int BoardGenerator::next()
+{
+    return current.fetchAndAddOrdered(1) + 1;
+}
+
+void BoardGenerator::cancel()
+{
+    current.fetchAndAddOrdered(1);
+}
+
+void BoardGenerator::request(int ticket, Grid grid, int mines, quint32 seed)
+{
+    // a newer request is already queued
+    if(ticket != current.loadAcquire())
+        return;
+
+    auto board = generate(grid, mines, seed, [this, ticket](int percent)
+    {
+        if(ticket != current.loadAcquire())
+            return false;
+        emit progress(ticket, percent);
+        return true;
+    });
+    if(board)
+        emit generated(ticket, board);
+}
@@ -0,0 +1,33 @@
+#ifndef BOARDGENERATOR_H
+#define BOARDGENERATOR_H
+
+#include <QtCore/QtCore>
+#include <functional>
+#include "Board.h"
+
+class BoardGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BoardGenerator(QObject* parent = 0);
+
+    // progress receives percent, and returns false to cancel generation
+    static QSharedPointer<const Board> generate(const Grid& grid, int mines, quint32 seed,
+                                                const std::function<bool(int)>& progress
+                                                = std::function<bool(int)>());
+
+    // thread safe, obsoletes every pending or running request
+    int next();
+    void cancel();
+
+    Q_SLOT void request(int ticket, Grid grid, int mines, quint32 seed);
+
+    Q_SIGNAL void progress(int ticket, int percent);
+    Q_SIGNAL void generated(int ticket, QSharedPointer<const Board> board);
+
+private:
+    QAtomicInt current;
+};
+
+#endif // BOARDGENERATOR_H
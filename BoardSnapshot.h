@@ -0,0 +1,36 @@
+#ifndef BOARDSNAPSHOT_H
+#define BOARDSNAPSHOT_H
+
+#include <QtCore/QtCore>
+#include "MineSweeper.h"
+
+// Immutable game position published after every change, readable from any
+// thread. Tile states are stored in pages, a new snapshot shares all pages
+// the game did not touch since the previous one.
+// Mines of the board are only meant to be read once the game is over
+struct BoardSnapshot
+{
+    static const int PageBits = 12;
+    static const int PageSize = 1 << PageBits;
+    typedef QVector<Tile::State> Page;
+
+    Tile::State tileState(int index) const
+    {
+        return pages.at(index >> PageBits).at(index & (PageSize - 1));
+    }
+
+    // number of an uncovered tile
+    int surroundingMines(int index) const
+    {
+        return board->surroundingMines.at(index);
+    }
+
+    quint64 version = 0;        // increases with every publication, across games
+    MineSweeper::State state = MineSweeper::State::Running;
+    int mineCount = 0;          // mines minus flags
+    int remaining = 0;          // covered tiles without mine
+    QSharedPointer<const Board> board;     // null before the first game
+    QVector<Page> pages;
+};
+
+#endif // BOARDSNAPSHOT_H
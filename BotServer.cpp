@@ -0,0 +1,289 @@
+#include "BotServer.h"
+#include "BoardGenerator.h"
+
+namespace {
+// request payload sizes, after the opcode
+const int NewGameSize = 13;
+const int MoveSize = 5;
+const int SubscribeSize = 1;
+
+const int MaxTiles = 10000 * 10000;
+
+template<typename T>
+void append(QByteArray& output, T value)
+{
+    value = qToLittleEndian(value);
+    output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+T take(const char* data)
+{
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(data));
+}
+
+// reply header with the payload size filled in by endReply
+int beginReply(QByteArray& output, BotServer::Reply reply)
+{
+    output.append(static_cast<char>(reply));
+    append<quint32>(output, 0);
+    return output.size();
+}
+
+void endReply(QByteArray& output, int start)
+{
+    qToLittleEndian<quint32>(output.size() - start,
+                             reinterpret_cast<uchar*>(output.data() + start - 4));
+}
+}
+
+struct BotServer::Session
+{
+    QLocalSocket* socket = nullptr;
+    MineSweeper* game = nullptr;
+    bool owned = false;         // game is deleted with the session
+    bool subscribed = false;
+    QByteArray input;           // requests not complete yet
+    QByteArray output;          // replies of the current read
+};
+
+BotServer::BotServer(MineSweeper* shared, QObject* parent)
+    : QObject(parent)
+    , shared(shared)
+{
+    connect(&server, &QLocalServer::newConnection,
+            this, &BotServer::connection);
+    if(shared)
+    {
+        connect(shared, &MineSweeper::played,
+                this, [this]() { played(this->shared); });
+    }
+}
+
+BotServer::~BotServer()
+{
+    Q_FOREACH(auto session, sessions)
+    {
+        session->socket->disconnect(this);
+        if(session->owned)
+            delete session->game;
+        delete session;
+    }
+}
+
+bool BotServer::listen(const QString& name)
+{
+    // a crashed server leaves its socket file behind
+    QLocalServer::removeServer(name);
+    return server.listen(name);
+}
+
+QString BotServer::errorString() const
+{
+    return server.errorString();
+}
+
+void BotServer::connection()
+{
+    while(server.hasPendingConnections())
+    {
+        Session* session = new Session();
+        session->socket = server.nextPendingConnection();
+        session->game = shared;
+        sessions << session;
+
+        connect(session->socket, &QLocalSocket::readyRead,
+                this, [this, session]() { read(session); });
+        connect(session->socket, &QLocalSocket::disconnected,
+                this, [this, session]()
+        {
+            sessions.removeOne(session);
+            if(session->owned)
+                delete session->game;
+            session->socket->deleteLater();
+            delete session;
+        });
+    }
+}
+
+void BotServer::read(Session* session)
+{
+    session->input.append(session->socket->readAll());
+    int used = handle(session, session->input.constData(), session->input.size());
+    if(used >= 0)
+        session->input.remove(0, used);
+
+    // one write for all replies, the buffer keeps its capacity
+    if(!session->output.isEmpty())
+    {
+        session->socket->write(session->output);
+        session->output.resize(0);
+    }
+    if(used < 0)
+        session->socket->disconnectFromServer();
+}
+
+int BotServer::handle(Session* session, const char* data, int size)
+{
+    current = session;
+    int offset = 0;
+    while(offset < size)
+    {
+        int payload = 0;
+        switch(static_cast<quint8>(data[offset]))
+        {
+        case NewGame:
+            payload = NewGameSize;
+            break;
+        case Move:
+            payload = MoveSize;
+            break;
+        case Query:
+            break;
+        case Subscribe:
+            payload = SubscribeSize;
+            break;
+        default:
+            appendError(session->output, Protocol);
+            current = nullptr;
+            return -1;
+        }
+
+        // wait for the rest of a split request
+        if(size - offset - 1 < payload)
+            break;
+
+        const char* request = data + offset + 1;
+        switch(static_cast<quint8>(data[offset]))
+        {
+        case NewGame:
+            newGame(session, request);
+            break;
+        case Move:
+            move(session, request);
+            break;
+        case Query:
+            query(session);
+            break;
+        case Subscribe:
+            session->subscribed = (request[0] != 0);
+            break;
+        }
+        offset += 1 + payload;
+    }
+    current = nullptr;
+    return offset;
+}
+
+void BotServer::newGame(Session* session, const char* data)
+{
+    int columns = take<quint16>(data);
+    int rows = take<quint16>(data + 2);
+    quint32 mines = take<quint32>(data + 4);
+    quint32 seed = take<quint32>(data + 8);
+    quint8 topology = static_cast<quint8>(data[12]);
+    // 65535 * 65535 overflows int, the size is checked in 64 bits first
+    qint64 tiles = static_cast<qint64>(columns) * rows;
+    if((columns < 1) || (rows < 1) || (tiles > MaxTiles)
+       || (mines >= static_cast<quint64>(tiles))
+       || (topology > static_cast<quint8>(Topology::Hexagonal)))
+    {
+        appendError(session->output, BadGame);
+        return;
+    }
+
+    if(!session->game)
+    {
+        // bots read codes, not snapshots, and never undo
+        session->game = new MineSweeper();
+        session->game->setHeadless(true);
+        session->owned = true;
+    }
+    Grid grid(columns, rows, 1, static_cast<Topology>(topology));
+    session->game->setTopology(grid.topology);
+    session->game->startGame(BoardGenerator::generate(grid, mines, seed));
+    emit started(session->game);
+
+    int start = beginReply(session->output, Started);
+    append<quint16>(session->output, columns);
+    append<quint16>(session->output, rows);
+    append<quint32>(session->output, mines);
+    endReply(session->output, start);
+}
+
+void BotServer::move(Session* session, const char* data)
+{
+    quint32 cell = take<quint32>(data);
+    quint8 button = static_cast<quint8>(data[4]);
+    MineSweeper* game = session->game;
+    if(!game || !game->getCells())
+    {
+        appendError(session->output, NoGame);
+        return;
+    }
+    if((cell >= static_cast<quint32>(game->getGrid().count()))
+       || ((button != Qt::LeftButton) && (button != Qt::RightButton) && (button != Qt::MidButton)))
+    {
+        appendError(session->output, BadCell);
+        return;
+    }
+
+    game->play(cell, static_cast<Qt::MouseButton>(button));
+    appendChanges(session->output, game);
+}
+
+void BotServer::query(Session* session)
+{
+    MineSweeper* game = session->game;
+    if(!game || !game->getCells())
+    {
+        appendError(session->output, NoGame);
+        return;
+    }
+
+    Observation::View view = game->observe();
+    int start = beginReply(session->output, Position);
+    append<quint8>(session->output, static_cast<quint8>(game->getState()));
+    append<quint16>(session->output, view.columns);
+    append<quint16>(session->output, view.rows);
+    int packed = session->output.size();
+    session->output.resize(packed + Observation::packedSize(view.count()));
+    Observation::pack(view, reinterpret_cast<quint8*>(session->output.data() + packed));
+    endReply(session->output, start);
+}
+
+void BotServer::played(MineSweeper* game)
+{
+    // the session that moved gets its reply in handle()
+    QByteArray frame;
+    Q_FOREACH(auto session, sessions)
+    {
+        if(!session->subscribed || (session == current) || (session->game != game))
+            continue;
+        if(frame.isEmpty())
+            appendChanges(frame, game);
+        session->socket->write(frame);
+    }
+}
+
+void BotServer::appendChanges(QByteArray& output, MineSweeper* game)
+{
+    const QVector<int>& changed = game->getChanged();
+    const quint8* codes = game->observe().data;
+    int start = beginReply(output, Changes);
+    append<quint8>(output, static_cast<quint8>(game->getState()));
+    append<quint32>(output, changed.size());
+    Q_FOREACH(int cell, changed)
+    {
+        append<quint32>(output, cell);
+        append<quint8>(output, codes[cell]);
+    }
+    endReply(output, start);
+}
+
+void BotServer::appendError(QByteArray& output, ErrorCode error)
+{
+    int start = beginReply(output, Error);
+    append<quint8>(output, error);
+    endReply(output, start);
+}
@@ -0,0 +1,79 @@
+#ifndef BOTSERVER_H
+#define BOTSERVER_H
+
+#include <QtCore/QtCore>
+#include <QtNetwork/QtNetwork>
+#include "MineSweeper.h"
+
+// Binary protocol for bot processes on the same machine, over a local socket
+// (a Unix domain socket, a named pipe on Windows). Integers are little
+// endian. Requests may be pipelined, the replies to everything that arrived
+// in one read are written at once.
+//
+// requests, opcode first:
+//   NewGame    1  u16 columns, u16 rows, u32 mines, u32 seed, u8 topology
+//   Move       2  u32 cell, u8 button (1 left, 2 right, 4 middle)
+//   Query      3
+//   Subscribe  4  u8 enabled
+// replies, opcode and u32 payload size first:
+//   Started    1  u16 columns, u16 rows, u32 mines
+//   Changes    2  u8 state, u32 count, count * (u32 cell, u8 Observation code)
+//   Position   3  u8 state, u16 columns, u16 rows, packed Observation codes
+//   Error    255  u8 error, the connection is closed after a Protocol error
+//
+// Every Move gets a Changes reply, possibly empty. Subscribed bots also get
+// Changes for moves made by others on a shared game, e.g. the GUI
+class BotServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Request : quint8 {
+        NewGame = 1,
+        Move,
+        Query,
+        Subscribe
+    };
+    enum Reply : quint8 {
+        Started = 1,
+        Changes,
+        Position,
+        Error = 255
+    };
+    enum ErrorCode : quint8 {
+        Protocol = 0,   // unknown opcode
+        NoGame,         // Move or Query before NewGame
+        BadCell,
+        BadGame         // NewGame with an impossible size or mine count
+    };
+
+    // without a shared game every connection plays its own
+    explicit BotServer(MineSweeper* shared = nullptr, QObject* parent = 0);
+    ~BotServer();
+
+    bool listen(const QString& name);
+    QString errorString() const;
+
+    // a game was started by a bot, views of a shared game rebind to it
+    Q_SIGNAL void started(MineSweeper* game);
+
+private:
+    struct Session;
+
+    Q_SLOT void connection();
+    void read(Session* session);
+    int handle(Session* session, const char* data, int size);
+    void newGame(Session* session, const char* data);
+    void move(Session* session, const char* data);
+    void query(Session* session);
+    void played(MineSweeper* game);
+    static void appendChanges(QByteArray& output, MineSweeper* game);
+    static void appendError(QByteArray& output, ErrorCode error);
+
+    QLocalServer server;
+    MineSweeper* shared;
+    QList<Session*> sessions;
+    Session* current = nullptr;     // session whose request is being handled
+};
+
+#endif // BOTSERVER_H
@@ -12,6 +12,9 @@ CustomDialog::CustomDialog(QPoint rowRange, QPoint colRange, QWidget* parent)
     ui->mineValue->setValue(ui->rowValue->value() * ui->colValue->value() / 3);
     setWindowFlags(Qt::Dialog | Qt::CustomizeWindowHint
                    | Qt::WindowTitleHint | Qt::WindowCloseButtonHint);
+
+    connect(&estimator, &DifficultyEstimator::estimated,
+            this, &CustomDialog::estimated);
 }
 
 CustomDialog::~CustomDialog()
@@ -29,6 +32,11 @@ int CustomDialog::getMineCount() const
     return ui->mineValue->value();
 }
 
+void CustomDialog::setTopology(Topology newTopology)
+{
+    topology = newTopology;
+}
+
 void CustomDialog::changeEvent(QEvent *e)
 {
     QDialog::changeEvent(e);
@@ -41,12 +49,58 @@ void CustomDialog::changeEvent(QEvent *e)
     }
 }
 
+void CustomDialog::showEvent(QShowEvent* e)
+{
+    QDialog::showEvent(e);
+    estimate();
+}
+
+void CustomDialog::hideEvent(QHideEvent* e)
+{
+    QDialog::hideEvent(e);
+    estimator.cancel();
+}
+
 void CustomDialog::on_rowValue_valueChanged(int)
 {
     ui->mineValue->setRange(1, ui->rowValue->value() * ui->colValue->value());
+    estimate();
 }
 
 void CustomDialog::on_colValue_valueChanged(int)
 {
     ui->mineValue->setRange(1, ui->rowValue->value() * ui->colValue->value());
+    estimate();
+}
+
+void CustomDialog::on_mineValue_valueChanged(int)
+{
+    estimate();
+}
+
+void CustomDialog::estimate()
+{
+    // values are set up before the dialog is shown
+    if(!isVisible())
+        return;
+    Grid grid(ui->colValue->value(), ui->rowValue->value(), 1, topology);
+    if(!DifficultyEstimator::isSupported(grid))
+    {
+        estimator.cancel();
+        ui->estimateValue->setText(tr("no estimate for this topology"));
+        return;
+    }
+    ui->estimateValue->setText(tr("estimating..."));
+    ticket = estimator.estimate(grid, ui->mineValue->value());
+}
+
+void CustomDialog::estimated(int ticket, DifficultyEstimator::Estimate estimate)
+{
+    if(ticket != this->ticket)
+        return;
+    ui->estimateValue->setText(tr("%1% +/- %2% won\n%3 guesses per game, %4 games")
+                               .arg(qRound(estimate.winRate() * 100))
+                               .arg(qRound(estimate.margin() * 100))
+                               .arg(estimate.guessesPerGame(), 0, 'f', 1)
+                               .arg(estimate.games));
 }
@@ -3,6 +3,7 @@
 
 #include <QtCore/QtCore>
 #include <QtWidgets/QtWidgets>
+#include "DifficultyEstimator.h"
 
 namespace Ui {
 class CustomDialog;
@@ -18,15 +19,27 @@ public:
 
     QSize getTileSize() const;
     int getMineCount() const;
+    // the estimate is for boards of this topology
+    void setTopology(Topology topology);
 
 protected:
     void changeEvent(QEvent *e);
+    void showEvent(QShowEvent* e);
+    void hideEvent(QHideEvent* e);
 
 private:
     Q_SLOT void on_rowValue_valueChanged(int value);
     Q_SLOT void on_colValue_valueChanged(int value);
+    Q_SLOT void on_mineValue_valueChanged(int value);
+
+    // solver win rate and guesses of the chosen size, refined in the background
+    void estimate();
+    Q_SLOT void estimated(int ticket, DifficultyEstimator::Estimate estimate);
 
     Ui::CustomDialog *ui;
+    DifficultyEstimator estimator;
+    int ticket = 0;
+    Topology topology = Topology::Square;
 };
 
 #endif // CUSTOMDIALOG_H
@@ -0,0 +1,143 @@
+#include "DifficultyEstimator.h"
+#include "BoardGenerator.h"
+#include "MineSweeper.h"
+#include "BitboardSolver.h"
+#include "PatternSolver.h"
+#include <random>
+
+namespace {
+const int MaxGames = 5000;
+const int StreamInterval = 100;     // ms between two estimates of a run
+}
+
+struct DifficultyEstimator::Run
+{
+    int ticket;
+    Grid grid;
+    int mines;
+    QAtomicInt seeds;               // next board to play
+    QMutex mutex;
+    Estimate estimate;
+    QElapsedTimer streamed;
+};
+
+// one per task, reused for all its games
+struct DifficultyEstimator::Worker
+{
+    MineSweeper logic;
+    PatternSolver patterns;
+    BitboardSolver solver;
+};
+
+DifficultyEstimator::DifficultyEstimator(QObject* parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<DifficultyEstimator::Estimate>("DifficultyEstimator::Estimate");
+    // long tasks on the global pool would hold up its short ones
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+DifficultyEstimator::~DifficultyEstimator()
+{
+    // tasks emit through this object
+    cancel();
+    pool.waitForDone();
+}
+
+bool DifficultyEstimator::isSupported(const Grid& grid)
+{
+    return BitboardSolver::isSupported(grid);
+}
+
+int DifficultyEstimator::estimate(const Grid& grid, int mines)
+{
+    // cancelled tasks stop within one move, the new ones queue behind them
+    int ticket = current.fetchAndAddOrdered(1) + 1;
+    if(!isSupported(grid))
+        return ticket;
+
+    QSharedPointer<Run> run = QSharedPointer<Run>::create();
+    run->ticket = ticket;
+    run->grid = grid;
+    run->mines = mines;
+    run->streamed.start();
+    for(int i=0;i<pool.maxThreadCount();++i)
+        QtConcurrent::run(&pool, [this, run]() { simulate(run); });
+    return ticket;
+}
+
+void DifficultyEstimator::cancel()
+{
+    current.fetchAndAddOrdered(1);
+}
+
+void DifficultyEstimator::simulate(QSharedPointer<Run> run)
+{
+    Worker worker;
+    worker.logic.setHeadless(true);
+    for(;;)
+    {
+        int seed = run->seeds.fetchAndAddRelaxed(1);
+        if((seed >= MaxGames) || (run->ticket != current.loadAcquire()))
+            return;
+
+        int guesses = 0;
+        bool won = play(*run, worker, seed, guesses);
+        if(run->ticket != current.loadAcquire())
+            return;
+
+        QMutexLocker locker(&run->mutex);
+        Estimate& estimate = run->estimate;
+        ++estimate.games;
+        estimate.wins += won;
+        estimate.guesses += guesses;
+        bool last = (estimate.games == qMin(MaxGames, run->seeds.loadAcquire()));
+        if(last || (run->streamed.elapsed() >= StreamInterval))
+        {
+            run->streamed.restart();
+            emit estimated(run->ticket, estimate);
+        }
+    }
+}
+
+bool DifficultyEstimator::play(const Run& run, Worker& worker, quint32 seed, int& guesses)
+{
+    MineSweeper& logic = worker.logic;
+    std::mt19937 random(seed);
+    logic.startGame(BoardGenerator::generate(run.grid, run.mines, seed));
+    const Cell* cells = logic.getCells();
+    QVector<int> covered;
+    while(logic.getState() == MineSweeper::State::Running)
+    {
+        if(run.ticket != current.loadAcquire())
+            return false;
+
+        PatternSolver::Result local = worker.patterns.solve(logic.observe());
+        QVector<int> safe = local.safe;
+        QVector<int> mines = local.mines;
+        if(safe.isEmpty() && mines.isEmpty())
+        {
+            worker.solver.load(run.grid, logic.observe(), logic.getMineCount());
+            BitboardSolver::Result result = worker.solver.solve();
+            safe = result.safe;
+            mines = result.mines;
+        }
+        if(safe.isEmpty() && mines.isEmpty())
+        {
+            covered.resize(0);
+            for(int i=0;i<run.grid.count();++i)
+            {
+                if((cells[i].state == Tile::Cover) || (cells[i].state == Tile::Tag))
+                    covered << i;
+            }
+            safe << covered.at(random() % covered.size());
+            ++guesses;
+        }
+
+        Q_FOREACH(int cell, mines)
+            logic.play(cell, Qt::RightButton);
+        Q_FOREACH(int cell, safe)
+            logic.play(cell, Qt::LeftButton);
+    }
+    return logic.getState() == MineSweeper::State::Success;
+}
@@ -0,0 +1,55 @@
+#ifndef DIFFICULTYESTIMATOR_H
+#define DIFFICULTYESTIMATOR_H
+
+#include <QtCore/QtCore>
+#include <QtConcurrent/QtConcurrent>
+#include "Grid.h"
+
+// Plays random boards of one size in the background: the pattern
+// table and the bitboard solver move, a random covered tile is guessed
+// whenever they are stuck, the first click included. Estimates are streamed
+// as games finish, a new request or cancel() stops the running one at once.
+// Runs on its own pool, one core is left to the shared one. Both solvers
+// read square boards only, other topologies get no estimate
+class DifficultyEstimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Estimate
+    {
+        int games = 0;
+        int wins = 0;
+        int guesses = 0;
+
+        qreal winRate() const { return games ? static_cast<qreal>(wins) / games : 0; }
+        qreal guessesPerGame() const { return games ? static_cast<qreal>(guesses) / games : 0; }
+        // half width of the 95% confidence interval of the win rate
+        qreal margin() const { return games ? 1.96 * qSqrt(winRate() * (1 - winRate()) / games) : 1; }
+    };
+
+    explicit DifficultyEstimator(QObject* parent = 0);
+    ~DifficultyEstimator();
+
+    static bool isSupported(const Grid& grid);
+
+    // obsoletes the running estimate, returns the ticket of the new one.
+    // Nothing is estimated for an unsupported grid
+    int estimate(const Grid& grid, int mines);
+    void cancel();
+
+    Q_SIGNAL void estimated(int ticket, DifficultyEstimator::Estimate estimate);
+
+private:
+    struct Run;
+    struct Worker;
+    void simulate(QSharedPointer<Run> run);
+    bool play(const Run& run, Worker& worker, quint32 seed, int& guesses);
+
+    QAtomicInt current;
+    QThreadPool pool;
+};
+
+Q_DECLARE_METATYPE(DifficultyEstimator::Estimate)
+
+#endif // DIFFICULTYESTIMATOR_H
@@ -0,0 +1,200 @@
+#include "Frontier.h"
+
+void CellSet::reset(int count, Arena& arena)
+{
+    int wordCount = (count + 63) >> 6;
+    summaryCount = (wordCount + 63) >> 6;
+    words = arena.create<quint64>(wordCount);
+    summary = arena.create<quint64>(summaryCount);
+    members = 0;
+}
+
+void CellSet::insert(int cell)
+{
+    int word = cell >> 6;
+    quint64 bit = Q_UINT64_C(1) << (cell & 63);
+    if(words[word] & bit)
+        return;
+    words[word] |= bit;
+    summary[word >> 6] |= Q_UINT64_C(1) << (word & 63);
+    ++members;
+}
+
+void CellSet::remove(int cell)
+{
+    int word = cell >> 6;
+    quint64 bit = Q_UINT64_C(1) << (cell & 63);
+    if(!(words[word] & bit))
+        return;
+    words[word] &= ~bit;
+    if(!words[word])
+        summary[word >> 6] &= ~(Q_UINT64_C(1) << (word & 63));
+    --members;
+}
+
+void Frontier::reset(const Grid& newGrid, Arena& arena)
+{
+    grid = newGrid;
+    kinds = arena.create<Kind>(grid.count());
+    counts = arena.create<quint8>(grid.count());
+    values = arena.create<quint8>(grid.count());
+    covered.reset(grid.count(), arena);
+    numbers.reset(grid.count(), arena);
+}
+
+void Frontier::update(const Cell* cells, const QVector<int>& changed)
+{
+    // changes are applied one at a time against the kinds seen so far,
+    // a cell changed later in the list is still in its old kind
+    for(int i=0;i<changed.size();++i)
+    {
+        int index = changed.at(i);
+        Kind next = kind(cells[index]);
+        if(next == kinds[index])
+            continue;
+        leave(index);
+        enter(index, next, cells[index].surroundingMines);
+    }
+}
+
+Frontier::Kind Frontier::kind(const Cell& cell)
+{
+    switch(cell.state)
+    {
+    case Tile::Cover:
+    case Tile::Tag:
+        return Unknown;
+    case Tile::Flag:
+        return Flagged;
+    case Tile::Explode:
+        return Revealed;
+    case Tile::Uncover:
+        break;
+    }
+    return (cell.surroundingMines > 0)?Number:Revealed;
+}
+
+void Frontier::leave(int index)
+{
+    switch(kinds[index])
+    {
+    case Unknown:
+        covered.remove(index);
+        break;
+    case Flagged:
+        grid.forEachNeighbour(index, [this](int neighbour)
+        {
+            if(kinds[neighbour] != Number)
+                return;
+            --counts[neighbour];
+            recheck(neighbour);
+        });
+        break;
+    case Number:
+        numbers.remove(index);
+        grid.forEachNeighbour(index, [this](int neighbour)
+        {
+            if((kinds[neighbour] <= Flagged) && (--counts[neighbour] == 0))
+                covered.remove(neighbour);
+        });
+        break;
+    case Revealed:
+        break;
+    }
+}
+
+void Frontier::enter(int index, Kind next, quint8 value)
+{
+    kinds[index] = next;
+    int count = 0;
+    switch(next)
+    {
+    case Unknown:
+        grid.forEachNeighbour(index, [this, &count](int neighbour)
+        {
+            count += (kinds[neighbour] == Number);
+        });
+        counts[index] = count;
+        if(count > 0)
+            covered.insert(index);
+        break;
+    case Flagged:
+        grid.forEachNeighbour(index, [this, &count](int neighbour)
+        {
+            if(kinds[neighbour] != Number)
+                return;
+            ++count;
+            ++counts[neighbour];
+            recheck(neighbour);
+        });
+        counts[index] = count;
+        break;
+    case Number:
+        values[index] = value;
+        grid.forEachNeighbour(index, [this, &count](int neighbour)
+        {
+            if(kinds[neighbour] == Unknown)
+            {
+                if(++counts[neighbour] == 1)
+                    covered.insert(neighbour);
+            }
+            else if(kinds[neighbour] == Flagged)
+            {
+                ++counts[neighbour];
+                ++count;
+            }
+        });
+        counts[index] = count;
+        recheck(index);
+        break;
+    case Revealed:
+        counts[index] = 0;
+        break;
+    }
+}
+
+void Frontier::recheck(int number)
+{
+    if(counts[number] < values[number])
+        numbers.insert(number);
+    else
+        numbers.remove(number);
+}
+
+bool Frontier::check(const Cell* cells) const
+{
+    int coveredCount = 0;
+    int numberCount = 0;
+    for(int i=0;i<grid.count();++i)
+    {
+        Kind expected = kind(cells[i]);
+        if(kinds[i] != expected)
+            return false;
+
+        int count = 0;
+        grid.forEachNeighbour(i, [&](int neighbour)
+        {
+            Kind other = kind(cells[neighbour]);
+            if((expected <= Flagged) && (other == Number))
+                ++count;
+            else if((expected == Number) && (other == Flagged))
+                ++count;
+        });
+        if((expected != Revealed) && (counts[i] != count))
+            return false;
+
+        bool isCovered = (expected == Unknown) && (count > 0);
+        bool isNumber = (expected == Number) && (count < cells[i].surroundingMines);
+        if((covered.contains(i) != isCovered) || (numbers.contains(i) != isNumber))
+            return false;
+        coveredCount += isCovered;
+        numberCount += isNumber;
+    }
+
+    // the summary must lead to exactly the members
+    int visited = 0;
+    covered.forEach([&visited](int) { ++visited; });
+    numbers.forEach([&visited](int) { ++visited; });
+    return (covered.size() == coveredCount) && (numbers.size() == numberCount)
+           && (visited == coveredCount + numberCount);
+}
@@ -0,0 +1,89 @@
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+#include <QtCore/QtCore>
+#include "Grid.h"
+#include "Tile.h"
+#include "Arena.h"
+
+// Set of cells as a two level bitmap: one bit per cell, and one bit per
+// non-empty word of cells. Updates are O(1), iteration visits the members
+// in ascending cell order and skips empty regions 4096 cells at a time
+class CellSet
+{
+public:
+    void reset(int count, Arena& arena);
+
+    int size() const { return members; }
+    bool isEmpty() const { return members == 0; }
+    bool contains(int cell) const { return words[cell >> 6] & (Q_UINT64_C(1) << (cell & 63)); }
+    void insert(int cell);
+    void remove(int cell);
+
+    // calls visit(int cell) for every member, the set must not change meanwhile
+    template<typename Visitor>
+    void forEach(Visitor&& visit) const
+    {
+        for(int s=0;s<summaryCount;++s)
+        {
+            quint64 summaryBits = summary[s];
+            while(summaryBits)
+            {
+                int word = (s << 6) + qCountTrailingZeroBits(summaryBits);
+                summaryBits &= summaryBits - 1;
+                quint64 bits = words[word];
+                while(bits)
+                {
+                    visit((word << 6) + static_cast<int>(qCountTrailingZeroBits(bits)));
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+private:
+    quint64* words = nullptr;
+    quint64* summary = nullptr;     // bit per non-zero word
+    int summaryCount = 0;
+    int members = 0;
+};
+
+// Covered cells next to uncovered numbers, and the unsatisfied numbers: those
+// with fewer flags around than their value. Flagged cells are not covered
+// cells of the frontier. Updated from the cells changed by a click, in
+// O(changed * neighbours)
+class Frontier
+{
+public:
+    // every cell covered, the state of a new game
+    void reset(const Grid& grid, Arena& arena);
+    void update(const Cell* cells, const QVector<int>& changed);
+
+    const CellSet& getCovered() const { return covered; }
+    const CellSet& getNumbers() const { return numbers; }
+
+    // rebuilds everything from cells and compares, for tests and benchmarks
+    bool check(const Cell* cells) const;
+
+private:
+    enum Kind : quint8 {
+        Unknown = 0,    // covered or tagged
+        Flagged,
+        Revealed,       // uncovered without surrounding mines, or exploded
+        Number
+    };
+    static Kind kind(const Cell& cell);
+    void leave(int index);
+    void enter(int index, Kind kind, quint8 value);
+    void recheck(int number);
+
+    Grid grid;
+    Kind* kinds = nullptr;      // kind of every cell as of the last update
+    quint8* counts = nullptr;   // number neighbours of a covered or flagged
+                                // cell, flagged neighbours of a number
+    quint8* values = nullptr;   // surrounding mines of a number
+    CellSet covered;
+    CellSet numbers;
+};
+
+#endif // FRONTIER_H
@@ -0,0 +1,311 @@
+#include "GLViewport.h"
+#include "Tile.h"
+#include "TileAssets.h"
+
+namespace {
+// atlas layout: every covered kind has 4 looks (bit 0 hover, bit 1 pressed),
+// followed by the uncovered numbers 0-8, the explosion and the uncovered mine
+enum AtlasCell {
+    CoverCell = 0,
+    FlagCell = 4,
+    TagCell = 8,
+    CoverMineCell = 12,
+    NumberCell = 16,
+    ExplodeCell = 25,
+    UncoverMineCell = 26,
+    AtlasCellCount = 27
+};
+const int AtlasColumns = 8;
+const int AtlasRows = (AtlasCellCount + AtlasColumns - 1) / AtlasColumns;
+
+const char* const VertexShader =
+        "in vec2 corner;\n"
+        "in vec3 instance;\n"
+        "uniform mat4 transform;\n"
+        "uniform float tileSize;\n"
+        "uniform vec2 atlasCells;\n"
+        "uniform vec2 texel;\n"
+        "out vec2 uv;\n"
+        "out vec2 local;\n"
+        "out vec2 cell;\n"
+        "void main()\n"
+        "{\n"
+        "    cell = instance.xy;\n"
+        "    local = corner * tileSize;\n"
+        "    vec2 origin = vec2(mod(instance.z, atlasCells.x), floor(instance.z / atlasCells.x));\n"
+        "    uv = (origin + texel + corner * (vec2(1.0) - texel * 2.0)) / atlasCells;\n"
+        "    gl_Position = transform * vec4((instance.xy + corner) * tileSize, 0.0, 1.0);\n"
+        "}\n";
+
+const char* const FragmentShader =
+        "in vec2 uv;\n"
+        "in vec2 local;\n"
+        "in vec2 cell;\n"
+        "uniform sampler2D atlas;\n"
+        "uniform vec4 gridColor;\n"
+        "out vec4 fragColor;\n"
+        "void main()\n"
+        "{\n"
+        "    fragColor = texture(atlas, uv);\n"
+        "    if(((cell.y > 0.5) && (local.y < 1.0)) || ((cell.x > 0.5) && (local.x < 1.0)))\n"
+        "        fragColor = gridColor;\n"
+        "}\n";
+}
+
+GLViewport::GLViewport(QWidget* parent)
+    : QOpenGLWidget(parent)
+    , quadBuffer(QOpenGLBuffer::VertexBuffer)
+    , instanceBuffer(QOpenGLBuffer::VertexBuffer)
+{
+    // QPainter on the viewport needs the compatibility profile,
+    // instancing needs at least OpenGL 3.3 (or OpenGL ES 3.0)
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CompatibilityProfile);
+    setFormat(format);
+}
+
+GLViewport::~GLViewport()
+{
+    if(!initialized)
+        return;
+
+    makeCurrent();
+    delete atlas;
+    instanceBuffer.destroy();
+    quadBuffer.destroy();
+    vao.destroy();
+    program.removeAllShaders();
+    doneCurrent();
+}
+
+bool GLViewport::isBatching() const
+{
+    return batching;
+}
+
+bool GLViewport::drawTiles(const QVector<QVector<QSharedPointer<Tile> > >& tiles,
+                           qreal tileSize,
+                           bool finished,
+                           const QTransform& transform,
+                           const QPalette& palette,
+                           const QFont& font)
+{
+    if(!initialized)
+        batching = initializeBatch();
+    if(!batching)
+        return false;
+
+    updateAtlas(tileSize, palette, font);
+
+    // collect tile instances
+    instances.resize(0);
+    Q_FOREACH(auto row, tiles)
+    {
+        Q_FOREACH(auto tile, row)
+        {
+            instances << tile->x() / tileSize
+                      << tile->y() / tileSize
+                      << atlasCell(tile.data(), finished);
+        }
+    }
+    if(instances.isEmpty())
+        return true;
+
+    // scene -> viewport -> normalized device coordinates
+    QMatrix4x4 matrix;
+    matrix.ortho(0, width(), height(), 0, -1, 1);
+    matrix *= QMatrix4x4(transform);
+
+    QOpenGLVertexArrayObject::Binder binder(&vao);
+    instanceBuffer.bind();
+    instanceBuffer.allocate(instances.constData(), instances.size() * sizeof(GLfloat));
+    instanceBuffer.release();
+
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+
+    program.bind();
+    program.setUniformValue("transform", matrix);
+    program.setUniformValue("tileSize", static_cast<GLfloat>(tileSize));
+    program.setUniformValue("atlasCells", QVector2D(AtlasColumns, AtlasRows));
+    program.setUniformValue("texel", QVector2D(0.5f / atlas->width() * AtlasColumns,
+                                               0.5f / atlas->height() * AtlasRows));
+    program.setUniformValue("gridColor", palette.background().color().darker());
+    program.setUniformValue("atlas", 0);
+
+    atlas->bind(0);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances.size() / 3);
+    atlas->release(0);
+    program.release();
+
+    return true;
+}
+
+bool GLViewport::initializeBatch()
+{
+    initialized = true;
+    initializeOpenGLFunctions();
+
+    QOpenGLContext* ctx = context();
+    bool es = ctx->isOpenGLES();
+    if(ctx->format().version() < qMakePair(3, es?0:3))
+    {
+        qWarning("GLViewport: OpenGL %d.%d can not draw instanced tiles, "
+                 "falling back to QPainter.",
+                 ctx->format().majorVersion(), ctx->format().minorVersion());
+        return false;
+    }
+
+    QByteArray header = es
+                        ? QByteArrayLiteral("#version 300 es\nprecision mediump float;\n")
+                        : QByteArrayLiteral("#version 330\n");
+    program.addShaderFromSourceCode(QOpenGLShader::Vertex, header + VertexShader);
+    program.addShaderFromSourceCode(QOpenGLShader::Fragment, header + FragmentShader);
+    program.bindAttributeLocation("corner", 0);
+    program.bindAttributeLocation("instance", 1);
+    if(!program.link())
+    {
+        qWarning("GLViewport: %s", qPrintable(program.log()));
+        return false;
+    }
+
+    vao.create();
+    QOpenGLVertexArrayObject::Binder binder(&vao);
+
+    // one unit quad shared by all tiles
+    static const GLfloat corners[] = {0, 0, 1, 0, 0, 1, 1, 1};
+    quadBuffer.create();
+    quadBuffer.bind();
+    quadBuffer.allocate(corners, sizeof(corners));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // per tile instance data
+    instanceBuffer.create();
+    instanceBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    instanceBuffer.bind();
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glVertexAttribDivisor(1, 1);
+
+    return true;
+}
+
+void GLViewport::updateAtlas(qreal tileSize, const QPalette& palette, const QFont& font)
+{
+    qreal ratio = devicePixelRatioF();
+    QString key = QStringLiteral("%1-%2-%3-%4").arg(tileSize)
+                                               .arg(ratio)
+                                               .arg(palette.cacheKey())
+                                               .arg(font.key());
+    if(atlas && (key == atlasKey))
+        return;
+    atlasKey = key;
+
+    int cellSize = qCeil(tileSize * ratio);
+    QImage image(cellSize * AtlasColumns, cellSize * AtlasRows,
+                 QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    QFont f = font;
+    f.setBold(true);
+    painter.setFont(f);
+    for(int cell=0;cell<AtlasCellCount;++cell)
+    {
+        painter.save();
+        painter.translate((cell % AtlasColumns) * cellSize, (cell / AtlasColumns) * cellSize);
+        painter.scale(ratio, ratio);
+        paintAtlasCell(&painter, QRectF(0, 0, tileSize, tileSize), cell, palette, ratio);
+        painter.restore();
+    }
+    painter.end();
+
+    delete atlas;
+    atlas = new QOpenGLTexture(image, QOpenGLTexture::DontGenerateMipMaps);
+    atlas->setMinificationFilter(QOpenGLTexture::Linear);
+    atlas->setMagnificationFilter(QOpenGLTexture::Linear);
+    atlas->setWrapMode(QOpenGLTexture::ClampToEdge);
+}
+
+void GLViewport::paintAtlasCell(QPainter* painter, const QRectF& rect, int cell,
+                                const QPalette& palette, qreal ratio)
+{
+    auto draw = [&](TileAssets::Image image)
+    {
+        painter->drawPixmap(TileAssets::rect(image, rect).topLeft(),
+                            TileAssets::pixmap(image, rect.width(), ratio));
+    };
+
+    // uncovered cells
+    if(cell >= NumberCell)
+    {
+        painter->fillRect(rect, palette.background());
+        if(cell == ExplodeCell)
+        {
+            draw(TileAssets::Explosion);
+        }
+        else if(cell == UncoverMineCell)
+        {
+            draw(TileAssets::Mine);
+        }
+        else if(cell > NumberCell)
+        {
+            quint8 mines = cell - NumberCell;
+            painter->setPen(Tile::numberColor(mines));
+            painter->drawText(rect, Qt::AlignCenter, QString::number(mines));
+        }
+        return;
+    }
+
+    // covered cells
+    bool hover = (cell & 1);
+    bool pressed = (cell & 2);
+    if(hover)
+        painter->fillRect(rect, palette.color(QPalette::Active, QPalette::Midlight));
+    else
+        painter->fillRect(rect, palette.color(QPalette::Active, QPalette::Button));
+
+    switch(cell & ~3)
+    {
+    case FlagCell:
+        draw(TileAssets::Flag);
+        break;
+    case TagCell:
+        draw(TileAssets::Tag);
+        break;
+    case CoverMineCell:
+        draw(TileAssets::Mine);
+        break;
+    default:
+        break;
+    }
+
+    TileAssets::paintBevel(painter, rect.toRect(), palette, pressed);
+}
+
+int GLViewport::atlasCell(const Tile* tile, bool finished)
+{
+    int look = (tile->isUnderMouse()?1:0)
+               | ((tile->isPressed(Qt::LeftButton) || tile->isPressed(Qt::MidButton))?2:0);
+    if(tile->isRevealPending())
+        return CoverCell + look;
+    switch(tile->state())
+    {
+    case Tile::Cover:
+        return ((finished && tile->isMine())?CoverMineCell:CoverCell) + look;
+    case Tile::Flag:
+        return FlagCell + look;
+    case Tile::Tag:
+        return TagCell + look;
+    case Tile::Explode:
+        return ExplodeCell;
+    case Tile::Uncover:
+        return tile->isMine()?UncoverMineCell:(NumberCell + tile->surroundingMines());
+    }
+    return CoverCell;
+}
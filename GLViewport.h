@@ -0,0 +1,42 @@
+#ifndef GLVIEWPORT_H
+#define GLVIEWPORT_H
+
+#include <QtCore/QtCore>
+#include <QtWidgets/QtWidgets>
+
+class Tile;
+class GLViewport : public QOpenGLWidget, protected QOpenGLExtraFunctions
+{
+    Q_OBJECT
+
+public:
+    explicit GLViewport(QWidget* parent = 0);
+    ~GLViewport();
+
+    bool isBatching() const;
+    bool drawTiles(const QVector<QVector<QSharedPointer<Tile> > >& tiles,
+                   qreal tileSize,
+                   bool finished,
+                   const QTransform& transform,
+                   const QPalette& palette,
+                   const QFont& font);
+
+private:
+    bool initializeBatch();
+    void updateAtlas(qreal tileSize, const QPalette& palette, const QFont& font);
+    void paintAtlasCell(QPainter* painter, const QRectF& rect, int cell,
+                        const QPalette& palette, qreal ratio);
+    static int atlasCell(const Tile* tile, bool finished);
+
+    bool batching = true;
+    bool initialized = false;
+    QOpenGLShaderProgram program;
+    QOpenGLVertexArrayObject vao;
+    QOpenGLBuffer quadBuffer;
+    QOpenGLBuffer instanceBuffer;
+    QOpenGLTexture* atlas = nullptr;
+    QString atlasKey;
+    QVector<GLfloat> instances;   // col, row, atlas cell for every tile
+};
+
+#endif // GLVIEWPORT_H
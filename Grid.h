@@ -0,0 +1,266 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <QtCore/QtCore>
+
+enum class Direction {
+    TopLeft = 0,
+    Top,
+    TopRight,
+    Left,
+    Right,
+    BottomLeft,
+    Bottom,
+    BottomRight
+};
+
+// column and row offsets, in Direction order
+constexpr int DirectionCount = 8;
+constexpr int DirectionX[DirectionCount] = {-1, 0, 1, -1, 1, -1, 0, 1};
+constexpr int DirectionY[DirectionCount] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+// hexagonal offsets, odd rows are shifted right by half a tile.
+// column offsets depend on the row parity
+constexpr int HexDirectionCount = 6;
+constexpr int HexDirectionX[2][HexDirectionCount] = {{-1, 0, -1, 1, -1, 0},
+                                                     {0, 1, -1, 1, 0, 1}};
+constexpr int HexDirectionY[HexDirectionCount] = {-1, -1, 0, 0, 1, 1};
+
+// cube offsets, all 26 cells around in the previous, same and next layer
+constexpr int CubeDirectionCount = 26;
+constexpr int CubeDirectionX[CubeDirectionCount] = {-1, 0, 1, -1, 0, 1, -1, 0, 1,
+                                                    -1, 0, 1, -1, 1, -1, 0, 1,
+                                                    -1, 0, 1, -1, 0, 1, -1, 0, 1};
+constexpr int CubeDirectionY[CubeDirectionCount] = {-1, -1, -1, 0, 0, 0, 1, 1, 1,
+                                                    -1, -1, -1, 0, 0, 1, 1, 1,
+                                                    -1, -1, -1, 0, 0, 0, 1, 1, 1};
+constexpr int CubeDirectionZ[CubeDirectionCount] = {-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                    0, 0, 0, 0, 0, 0, 0, 0,
+                                                    1, 1, 1, 1, 1, 1, 1, 1, 1};
+
+enum class Border {
+    Checked = 0,    // neighbours may be outside of the grid
+    Unchecked       // all neighbours exist
+};
+
+enum class Topology {
+    Square = 0,     // 8 neighbours, bounded
+    Torus,          // 8 neighbours, wrapping around the edges
+    Hexagonal,      // 6 neighbours, odd rows shifted right by half a tile
+    Cube            // 26 neighbours in a stack of layers
+};
+
+// Cell indexing of a board: index = (layer * rows + row) * columns + col.
+// Neighbour iteration is forwarded to the neighbourhood policy of the topology
+struct Grid
+{
+    Grid(int columns = 0, int rows = 0, int layers = 1, Topology topology = Topology::Square)
+        : columns(columns)
+        , rows(rows)
+        , layers(layers)
+        , topology(topology)
+    {}
+
+    int count() const { return columns * rows * layers; }
+    int index(int col, int row, int layer = 0) const { return (layer * rows + row) * columns + col; }
+    int index(const QPoint& pos) const { return index(pos.x(), pos.y()); }
+    QPoint pos(int index) const { return QPoint(index % columns, (index / columns) % rows); }
+    int layer(int index) const { return index / (columns * rows); }
+
+    bool contains(int col, int row, int layer = 0) const
+    {
+        return ((col >= 0) && (col < columns))
+               && ((row >= 0) && (row < rows))
+               && ((layer >= 0) && (layer < layers));
+    }
+
+    bool isInterior(int col, int row) const
+    {
+        return ((col > 0) && (col < columns - 1))
+               && ((row > 0) && (row < rows - 1));
+    }
+
+    int maxNeighbours() const;
+
+    // calls visit(int neighbourIndex) for every existing neighbour
+    template<typename Visitor>
+    void forEachNeighbour(int index, Visitor&& visit) const;
+
+    int columns;
+    int rows;
+    int layers;
+    Topology topology;
+};
+
+struct SquareNeighbourhood
+{
+    template<Border border, typename Visitor>
+    static void walk(const Grid& grid, int col, int row, Visitor&& visit)
+    {
+        int index = grid.index(col, row);
+        for(int i=0;i<DirectionCount;++i)
+        {
+            if((border == Border::Checked)
+               && !grid.contains(col + DirectionX[i], row + DirectionY[i]))
+                continue;
+            visit(index + DirectionY[i] * grid.columns + DirectionX[i]);
+        }
+    }
+
+    // interior cells, the vast majority, skip all bounds checks
+    template<typename Visitor>
+    static void forEach(const Grid& grid, int index, Visitor&& visit)
+    {
+        int col = index % grid.columns;
+        int row = index / grid.columns;
+        if(grid.isInterior(col, row))
+            walk<Border::Unchecked>(grid, col, row, visit);
+        else
+            walk<Border::Checked>(grid, col, row, visit);
+    }
+};
+
+struct TorusNeighbourhood
+{
+    template<typename Visitor>
+    static void forEach(const Grid& grid, int index, Visitor&& visit)
+    {
+        int col = index % grid.columns;
+        int row = index / grid.columns;
+        if(grid.isInterior(col, row))
+        {
+            SquareNeighbourhood::walk<Border::Unchecked>(grid, col, row, visit);
+            return;
+        }
+
+        // wrapped columns and rows, selected without a branch per neighbour
+        const int cols[3] = {(col + grid.columns - 1) % grid.columns,
+                             col,
+                             (col + 1) % grid.columns};
+        const int rows[3] = {(row + grid.rows - 1) % grid.rows,
+                             row,
+                             (row + 1) % grid.rows};
+        if((grid.columns >= 3) && (grid.rows >= 3))
+        {
+            for(int i=0;i<DirectionCount;++i)
+                visit(rows[DirectionY[i] + 1] * grid.columns + cols[DirectionX[i] + 1]);
+            return;
+        }
+
+        // a torus narrower than 3 wraps onto the same tiles again, every
+        // neighbour is visited once and the tile itself never
+        for(int y=0;y<3;++y)
+        {
+            if(((y > 0) && (rows[y] == rows[0])) || ((y > 1) && (rows[y] == rows[1])))
+                continue;
+            for(int x=0;x<3;++x)
+            {
+                if(((x > 0) && (cols[x] == cols[0])) || ((x > 1) && (cols[x] == cols[1])))
+                    continue;
+                if((rows[y] == row) && (cols[x] == col))
+                    continue;
+                visit(rows[y] * grid.columns + cols[x]);
+            }
+        }
+    }
+};
+
+struct HexagonalNeighbourhood
+{
+    template<Border border, typename Visitor>
+    static void walk(const Grid& grid, int col, int row, Visitor&& visit)
+    {
+        int index = grid.index(col, row);
+        const int* offsetX = HexDirectionX[row & 1];
+        for(int i=0;i<HexDirectionCount;++i)
+        {
+            if((border == Border::Checked)
+               && !grid.contains(col + offsetX[i], row + HexDirectionY[i]))
+                continue;
+            visit(index + HexDirectionY[i] * grid.columns + offsetX[i]);
+        }
+    }
+
+    template<typename Visitor>
+    static void forEach(const Grid& grid, int index, Visitor&& visit)
+    {
+        int col = index % grid.columns;
+        int row = index / grid.columns;
+        if(grid.isInterior(col, row))
+            walk<Border::Unchecked>(grid, col, row, visit);
+        else
+            walk<Border::Checked>(grid, col, row, visit);
+    }
+};
+
+struct CubeNeighbourhood
+{
+    template<Border border, typename Visitor>
+    static void walk(const Grid& grid, int col, int row, int layer, Visitor&& visit)
+    {
+        int index = grid.index(col, row, layer);
+        int area = grid.columns * grid.rows;
+        for(int i=0;i<CubeDirectionCount;++i)
+        {
+            if((border == Border::Checked)
+               && !grid.contains(col + CubeDirectionX[i],
+                                 row + CubeDirectionY[i],
+                                 layer + CubeDirectionZ[i]))
+                continue;
+            visit(index + CubeDirectionZ[i] * area
+                  + CubeDirectionY[i] * grid.columns
+                  + CubeDirectionX[i]);
+        }
+    }
+
+    template<typename Visitor>
+    static void forEach(const Grid& grid, int index, Visitor&& visit)
+    {
+        int col = index % grid.columns;
+        int row = (index / grid.columns) % grid.rows;
+        int layer = index / (grid.columns * grid.rows);
+        if(grid.isInterior(col, row) && (layer > 0) && (layer < grid.layers - 1))
+            walk<Border::Unchecked>(grid, col, row, layer, visit);
+        else
+            walk<Border::Checked>(grid, col, row, layer, visit);
+    }
+};
+
+inline int Grid::maxNeighbours() const
+{
+    switch(topology)
+    {
+    case Topology::Hexagonal:
+        return HexDirectionCount;
+    case Topology::Cube:
+        return CubeDirectionCount;
+    case Topology::Square:
+    case Topology::Torus:
+        break;
+    }
+    return DirectionCount;
+}
+
+template<typename Visitor>
+inline void Grid::forEachNeighbour(int index, Visitor&& visit) const
+{
+    switch(topology)
+    {
+    case Topology::Square:
+        SquareNeighbourhood::forEach(*this, index, visit);
+        break;
+    case Topology::Torus:
+        TorusNeighbourhood::forEach(*this, index, visit);
+        break;
+    case Topology::Hexagonal:
+        HexagonalNeighbourhood::forEach(*this, index, visit);
+        break;
+    case Topology::Cube:
+        CubeNeighbourhood::forEach(*this, index, visit);
+        break;
+    }
+}
+
+Q_DECLARE_METATYPE(Grid)
+
+#endif // GRID_H
@@ -0,0 +1,58 @@
+#include "Journal.h"
+
+void Journal::clear()
+{
+    deltas.resize(0);
+    moves.resize(1);
+    cursor = 0;
+    undone = 0;
+    recording = false;
+}
+
+bool Journal::isEnabled() const
+{
+    return enabled;
+}
+
+void Journal::setEnabled(bool enable)
+{
+    enabled = enable;
+    clear();
+}
+
+int Journal::getUndoCount() const
+{
+    return undone;
+}
+
+bool Journal::canUndo() const
+{
+    return cursor > 0;
+}
+
+bool Journal::canRedo() const
+{
+    return cursor < moves.size() - 1;
+}
+
+void Journal::begin()
+{
+    recording = false;
+}
+
+void Journal::start()
+{
+    // a new move replaces the undone ones
+    recording = true;
+    deltas.resize(moves.at(cursor));
+    moves.resize(cursor + 1);
+}
+
+void Journal::end()
+{
+    if(!recording)
+        return;
+    recording = false;
+    moves.append(deltas.size());
+    ++cursor;
+}
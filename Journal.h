@@ -0,0 +1,77 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <QtCore/QtCore>
+#include "Tile.h"
+
+// Undo and redo history of one game. A move is stored as the tiles it
+// changed with their other state, 4 bytes per tile, so the history grows
+// with the tiles changed and not with the board size. Undo and redo swap
+// the stored states with the board, a move turns into its inverse
+class Journal
+{
+public:
+    struct Delta
+    {
+        quint32 cell : 29;
+        quint32 state : 3;      // Tile::State
+    };
+
+    void clear();
+    // a disabled journal records nothing, for engines that never undo
+    bool isEnabled() const;
+    void setEnabled(bool enable);
+    int getUndoCount() const;
+    bool canUndo() const;
+    bool canRedo() const;
+
+    // a move records the previous state of every tile it changes. The redo
+    // history is dropped by the first change, moves changing nothing vanish
+    void begin();
+    void record(int cell, Tile::State previous)
+    {
+        if(!enabled)
+            return;
+        if(!recording)
+            start();
+        deltas.append(Delta{static_cast<quint32>(cell), previous});
+    }
+    void end();
+
+    // calls swap(Delta&) for the deltas of the last done move, backwards
+    template<typename Function>
+    void undo(Function swap)
+    {
+        if(!canUndo())
+            return;
+        --cursor;
+        ++undone;
+        for(int i=moves.at(cursor + 1)-1;i>=moves.at(cursor);--i)
+            swap(deltas[i]);
+    }
+
+    // calls swap(Delta&) for the deltas of the next undone move
+    template<typename Function>
+    void redo(Function swap)
+    {
+        if(!canRedo())
+            return;
+        for(int i=moves.at(cursor);i<moves.at(cursor + 1);++i)
+            swap(deltas[i]);
+        ++cursor;
+    }
+
+private:
+    void start();
+
+    QVector<Delta> deltas;
+    QVector<int> moves = QVector<int>(1, 0);    // first delta of every move, and the end
+    int cursor = 0;             // moves done
+    int undone = 0;             // undos since clear()
+    bool recording = false;
+    bool enabled = true;
+};
+
+Q_DECLARE_TYPEINFO(Journal::Delta, Q_PRIMITIVE_TYPE);
+
+#endif // JOURNAL_H
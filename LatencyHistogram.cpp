@@ -0,0 +1,87 @@
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram()
+    : buckets(Buckets, 0)
+{
+}
+
+void LatencyHistogram::record(qint64 nsecs)
+{
+    nsecs = qMax<qint64>(0, nsecs);
+    ++buckets[bucket(nsecs)];
+    ++samples;
+    total += nsecs;
+    maximum = qMax(maximum, nsecs);
+}
+
+void LatencyHistogram::clear()
+{
+    buckets.fill(0);
+    samples = 0;
+    total = 0;
+    maximum = 0;
+}
+
+qint64 LatencyHistogram::count() const
+{
+    return samples;
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return maximum;
+}
+
+qint64 LatencyHistogram::mean() const
+{
+    return samples ? total / samples : 0;
+}
+
+qint64 LatencyHistogram::percentile(qreal percent) const
+{
+    // upper bound of the bucket holding the sample, clamped to the maximum
+    qint64 rank = qCeil(samples * percent / 100);
+    qint64 seen = 0;
+    for(int i=0;i<Buckets;++i)
+    {
+        seen += buckets.at(i);
+        if((seen >= rank) && (seen > 0))
+            return qMin(upperBound(i), maximum);
+    }
+    return maximum;
+}
+
+QString LatencyHistogram::summary() const
+{
+    auto ms = [](qint64 nsecs)
+    {
+        return QString::number(nsecs / 1000000.0, 'f', 2);
+    };
+    return QStringLiteral("n %1  p50 %2 ms  p99 %3 ms  max %4 ms")
+            .arg(samples)
+            .arg(ms(percentile(50)))
+            .arg(ms(percentile(99)))
+            .arg(ms(maximum));
+}
+
+int LatencyHistogram::bucket(qint64 nsecs)
+{
+    // below SubBuckets every value has its own bucket
+    if(nsecs < SubBuckets)
+        return static_cast<int>(nsecs);
+
+    // octave from the highest bit, sub bucket from the next 4 bits
+    int octave = 63 - qCountLeadingZeroBits(static_cast<quint64>(nsecs));
+    int sub = static_cast<int>(nsecs >> (octave - 4)) & (SubBuckets - 1);
+    return qMin(Buckets - 1, (octave - 3) * SubBuckets + sub);
+}
+
+qint64 LatencyHistogram::upperBound(int bucket)
+{
+    if(bucket < SubBuckets)
+        return bucket;
+
+    int octave = bucket / SubBuckets + 3;
+    int sub = bucket % SubBuckets;
+    return ((static_cast<qint64>(SubBuckets + sub) + 1) << (octave - 4)) - 1;
+}
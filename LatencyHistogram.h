@@ -0,0 +1,36 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtCore/QtCore>
+
+// Latency samples in ns, kept in logarithmic buckets of 1/16 octave.
+// Percentiles are exact to about 4%, memory stays constant.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 nsecs);
+    void clear();
+
+    qint64 count() const;
+    qint64 max() const;
+    qint64 mean() const;
+    qint64 percentile(qreal percent) const;
+
+    QString summary() const;
+
+private:
+    static const int SubBuckets = 16;
+    static const int Buckets = 64 * SubBuckets;
+
+    static int bucket(qint64 nsecs);
+    static qint64 upperBound(int bucket);
+
+    QVector<qint64> buckets;
+    qint64 samples = 0;
+    qint64 total = 0;
+    qint64 maximum = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
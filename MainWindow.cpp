@@ -1,6 +1,9 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
 #include "CustomDialog.h"
+#include "BoardGenerator.h"
+#include "RankList.h"
+#include "BotServer.h"
 
 MainWindow::MainWindow(QWidget* parent) :
     QMainWindow(parent),
@@ -14,9 +17,42 @@ MainWindow::MainWindow(QWidget* parent) :
 
 MainWindow::~MainWindow()
 {
+    generator->cancel();
+    generatorThread.quit();
+    generatorThread.wait();
     delete ui;
 }
 
+QString MainWindow::latencyReport() const
+{
+    return ui->mineField->latencyReport();
+}
+
+MineSweeper* MainWindow::getLogic() const
+{
+    return logic;
+}
+
+void MainWindow::attach(BotServer* server)
+{
+    connect(server, &BotServer::started,
+            this, &MainWindow::botStarted);
+
+    // a bot moves far faster than the screen refreshes
+    refresh.setSingleShot(true);
+    refresh.setInterval(16);
+    connect(&refresh, &QTimer::timeout,
+            this, &MainWindow::update);
+    disconnect(logic, &MineSweeper::update,
+               this, &MainWindow::update);
+    connect(logic, &MineSweeper::update,
+            this, [this]()
+    {
+        if(!refresh.isActive())
+            refresh.start();
+    });
+}
+
 void MainWindow::changeEvent(QEvent* e)
 {
     QMainWindow::changeEvent(e);
@@ -49,6 +85,18 @@ void MainWindow::on_actionRestart_triggered()
     startGame(logic->getDifficulty());
 }
 
+void MainWindow::on_actionUndo_triggered()
+{
+    logic->undo();
+    resumed();
+}
+
+void MainWindow::on_actionRedo_triggered()
+{
+    logic->redo();
+    resumed();
+}
+
 void MainWindow::on_actionSimple_triggered()
 {
     startGame(MineSweeper::Difficulty::Simple);
@@ -66,6 +114,7 @@ void MainWindow::on_actionHard_triggered()
 
 void MainWindow::on_actionCustom_triggered()
 {
+    customDialog->setTopology(logic->getTopology());
     switch(customDialog->exec())
     {
     case QDialog::Accepted:
@@ -83,6 +132,31 @@ void MainWindow::on_actionRank_triggered()
     ;
 }
 
+void MainWindow::on_actionSquare_triggered()
+{
+    setTopology(Topology::Square);
+}
+
+void MainWindow::on_actionTorus_triggered()
+{
+    setTopology(Topology::Torus);
+}
+
+void MainWindow::on_actionHexagonal_triggered()
+{
+    setTopology(Topology::Hexagonal);
+}
+
+void MainWindow::on_actionOpenGL_toggled(bool checked)
+{
+    ui->mineField->setOpenGL(checked);
+}
+
+void MainWindow::on_actionAutoChord_toggled(bool checked)
+{
+    logic->setAutoChord(checked);
+}
+
 void MainWindow::on_actionQuit_triggered()
 {
     qApp->quit();
@@ -121,6 +195,12 @@ void MainWindow::success()
 {
     finished = true;
     ui->buttonRestart->setIcon(QIcon(":/image/cool"));
+    // practice games with undo and bot games are not ranked
+    if(ranked && (logic->getUndoCount() == 0))
+    {
+        BoardStatistics statistics = logic->getStatistics();
+        ranks->insert(logic->getDifficulty(), logic->getTime(), statistics.bbbv, statistics.optimal);
+    }
 
     ui->mineField->success();
 }
@@ -153,6 +233,17 @@ void MainWindow::initUi()
                                     ui->timeLayout->sizeHint().height() + 12);
     ui->buttonRestart->setIconSize(ui->buttonRestart->size());
 
+    QActionGroup* topologies = new QActionGroup(this);
+    topologies->addAction(ui->actionSquare);
+    topologies->addAction(ui->actionTorus);
+    topologies->addAction(ui->actionHexagonal);
+
+    progressBar = new QProgressBar(ui->mineField);
+    progressBar->setRange(0, 100);
+    progressBar->hide();
+
+    ui->actionUndo->setShortcuts(QKeySequence::Undo);
+    ui->actionRedo->setShortcuts(QKeySequence::Redo);
     ui->actionQuit->setShortcuts(QKeySequence::Quit);
     ui->actionHelp->setShortcuts(QKeySequence::HelpContents);
 
@@ -163,7 +254,9 @@ void MainWindow::initUi()
 
 void MainWindow::initLogic()
 {
-    logic = MineSweeper::instance();
+    logic = new MineSweeper(this);
+    ranks = new RankList(this);
+    ui->mineField->setLogic(logic);
     connect(logic, &MineSweeper::success,
             this, &MainWindow::success);
     connect(logic, &MineSweeper::explode,
@@ -171,12 +264,28 @@ void MainWindow::initLogic()
     connect(logic, &MineSweeper::update,
             this, &MainWindow::update);
 
+    // boards are generated on a worker thread, stale results are dropped by ticket
+    generator = new BoardGenerator();
+    generator->moveToThread(&generatorThread);
+    connect(&generatorThread, &QThread::finished,
+            generator, &QObject::deleteLater);
+    connect(this, &MainWindow::generate,
+            generator, &BoardGenerator::request);
+    connect(generator, &BoardGenerator::progress,
+            this, &MainWindow::progress);
+    connect(generator, &BoardGenerator::generated,
+            this, &MainWindow::generated);
+    generatorThread.start();
+
     customDialog = new CustomDialog(logic->getColumnRange(), logic->getRowRange(), this);
 
-    logic->init(this, QSize(ui->mainLayout->contentsMargins().left()
-                            + ui->mainLayout->contentsMargins().right()
-                            + 4,
-                            height() - 2));
+    // boards follow the orientation of the screen
+    QSize size = qApp->desktop()->availableGeometry(this).size() * 0.9;
+    size -= QSize(ui->mainLayout->contentsMargins().left()
+                  + ui->mainLayout->contentsMargins().right()
+                  + 4,
+                  height() - 2);
+    logic->setScreenHorizontal(size.width() >= size.height());
 
     connect(&timer, &QTimer::timeout,
             this, &MainWindow::timeout);
@@ -185,18 +294,48 @@ void MainWindow::initLogic()
 }
 
 void MainWindow::initField()
+{
+    fitTileSize();
+    ui->mineField->init();
+
+    // tiles are fitted to the screen the window is on
+    create();
+    connect(windowHandle(), &QWindow::screenChanged,
+            this, &MainWindow::screenChanged);
+    watchScreen(windowHandle()->screen());
+}
+
+void MainWindow::fitTileSize()
 {
     QMargins margins = ui->centralwidget->layout()->contentsMargins();
-    baseSize = QSize(margins.left() + margins.right() + ui->frame->lineWidth() * 2,
+    QSize chromeSize(margins.left() + margins.right() + ui->frame->lineWidth() * 2,
                      height());
-    QSize baseWindowSize = frameGeometry().size() - size() + baseSize;
-    QSizeF maxFieldSize = qApp->desktop()->availableGeometry().size() - baseWindowSize;
+    QSize baseWindowSize = frameGeometry().size() - size() + chromeSize;
+    QSizeF maxFieldSize = qApp->desktop()->availableGeometry(this).size() - baseWindowSize;
     qreal maxTileWidth = maxFieldSize.width() / logic->getColumnRange().y() - 1;
     qreal maxTileHeight = maxFieldSize.height() / logic->getRowRange().y() - 1;
-    Tile::setSize(std::min(maxTileWidth, maxTileHeight));
-    baseSize = QSize();
+    ui->mineField->setTileSize(std::min(maxTileWidth, maxTileHeight));
+}
 
-    ui->mineField->init();
+void MainWindow::watchScreen(QScreen* screen)
+{
+    disconnect(dpiConnection);
+    if(!screen)
+        return;
+    dpiConnection = connect(screen, &QScreen::logicalDotsPerInchChanged,
+                            this, [this]()
+    {
+        screenChanged(windowHandle()->screen());
+    });
+}
+
+void MainWindow::setTopology(Topology topology)
+{
+    if(topology == logic->getTopology())
+        return;
+
+    logic->setTopology(topology);
+    startGame(logic->getDifficulty());
 }
 
 void MainWindow::startGame(MineSweeper::Difficulty difficulty, bool resize)
@@ -204,14 +343,63 @@ void MainWindow::startGame(MineSweeper::Difficulty difficulty, bool resize)
     finished = false;
     ui->buttonRestart->setIcon(QIcon(":/image/smile"));
 
-    logic->startGame(difficulty, tileSize, maxMineCount);
+    logic->setupGame(difficulty, tileSize, maxMineCount);
 
     tileSize = logic->getTileSize();
     maxMineCount = logic->getMaxMineCount();
 
+    // cancels the generation still running, if any
+    ticket = generator->next();
+    resizeField = resize;
+    Grid grid(tileSize.width(), tileSize.height(), 1, logic->getTopology());
+
+    // window geometry is derived from the first board, generate it in place
+    if(!resize)
+    {
+        generated(ticket, BoardGenerator::generate(grid, maxMineCount, qrand()));
+        return;
+    }
+
+    ui->mineField->setEnabled(false);
+    emit generate(ticket, grid, maxMineCount, qrand());
+}
+
+void MainWindow::resumed()
+{
+    // undo brings a finished game back
+    if(!finished || (logic->getState() != MineSweeper::State::Running))
+        return;
+    finished = false;
+    ui->buttonRestart->setIcon(QIcon(":/image/smile"));
+    ui->mineField->setEnabled(true);
+}
+
+void MainWindow::progress(int ticket, int percent)
+{
+    if(ticket != this->ticket)
+        return;
+
+    progressBar->setValue(percent);
+    QRect rect(QPoint(), progressBar->sizeHint());
+    rect.setWidth(ui->mineField->width() / 2);
+    rect.moveCenter(ui->mineField->rect().center());
+    progressBar->setGeometry(rect);
+    progressBar->show();
+    progressBar->raise();
+}
+
+void MainWindow::generated(int ticket, QSharedPointer<const Board> board)
+{
+    if(ticket != this->ticket)
+        return;
+
+    progressBar->hide();
+    logic->startGame(board);
+    ranked = true;
+
     ui->mineField->started();
 
-    if(resize)
+    if(resizeField)
         setFixedSize(baseSize + ui->mineField->size());
 
     QRect rect = frameGeometry();
@@ -221,6 +409,50 @@ void MainWindow::startGame(MineSweeper::Difficulty difficulty, bool resize)
     update();
 }
 
+void MainWindow::botStarted()
+{
+    // a board from a bot obsoletes the one being generated
+    ticket = generator->next();
+    progressBar->hide();
+    finished = false;
+    ui->buttonRestart->setIcon(QIcon(":/image/smile"));
+    // size and mines are the bot's, not those of the difficulty
+    ranked = false;
+
+    // the bot may have picked another topology
+    switch(logic->getTopology())
+    {
+    case Topology::Square:
+        ui->actionSquare->setChecked(true);
+        break;
+    case Topology::Torus:
+        ui->actionTorus->setChecked(true);
+        break;
+    case Topology::Hexagonal:
+        ui->actionHexagonal->setChecked(true);
+        break;
+    default:
+        break;
+    }
+
+    ui->mineField->started();
+    if(baseSize.isValid())
+        setFixedSize(baseSize + ui->mineField->size());
+    update();
+}
+
+void MainWindow::screenChanged(QScreen* screen)
+{
+    watchScreen(screen);
+
+    // tile assets are cached per pixel ratio, only the layout is redone
+    fitTileSize();
+    ui->mineField->init();
+    ui->mineField->started();
+    if(baseSize.isValid())
+        setFixedSize(baseSize + ui->mineField->size());
+}
+
 void MainWindow::timeout()
 {
     ui->timeNum->display(QStringLiteral("%1").arg(logic->getTime(),
@@ -9,6 +9,9 @@ class MainWindow;
 }
 
 class CustomDialog;
+class BoardGenerator;
+class RankList;
+class BotServer;
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -17,16 +20,30 @@ public:
     explicit MainWindow(QWidget* parent = 0);
     ~MainWindow();
 
+    QString latencyReport() const;
+    MineSweeper* getLogic() const;
+    // shows the games bots play on the server, repainted at most once a frame
+    void attach(BotServer* server);
+
+    Q_SIGNAL void generate(int ticket, Grid grid, int mines, quint32 seed);
+
 protected:
     void changeEvent(QEvent* e);
     void resizeEvent(QResizeEvent *e);
 
     Q_SLOT void on_actionRestart_triggered();
+    Q_SLOT void on_actionUndo_triggered();
+    Q_SLOT void on_actionRedo_triggered();
     Q_SLOT void on_actionSimple_triggered();
     Q_SLOT void on_actionNormal_triggered();
     Q_SLOT void on_actionHard_triggered();
     Q_SLOT void on_actionCustom_triggered();
     Q_SLOT void on_actionRank_triggered();
+    Q_SLOT void on_actionSquare_triggered();
+    Q_SLOT void on_actionTorus_triggered();
+    Q_SLOT void on_actionHexagonal_triggered();
+    Q_SLOT void on_actionOpenGL_toggled(bool checked);
+    Q_SLOT void on_actionAutoChord_toggled(bool checked);
     Q_SLOT void on_actionQuit_triggered();
     Q_SLOT void on_actionHelp_triggered();
     Q_SLOT void on_actionAbout_triggered();
@@ -43,21 +60,39 @@ private:
     void initUi();
     void initLogic();
     void initField();
+    void fitTileSize();
+    void watchScreen(QScreen* screen);
+    void setTopology(Topology topology);
     void startGame(MineSweeper::Difficulty difficulty, bool resize = true);
+    void resumed();
 
+    Q_SLOT void progress(int ticket, int percent);
+    Q_SLOT void generated(int ticket, QSharedPointer<const Board> board);
+    Q_SLOT void botStarted();
     Q_SLOT void timeout();
+    Q_SLOT void screenChanged(QScreen* screen);
 
     Ui::MainWindow* ui;
     MineSweeper* logic;
+    RankList* ranks;
     CustomDialog* customDialog;
+    QProgressBar* progressBar;
+
+    QThread generatorThread;
+    BoardGenerator* generator;
+    int ticket = 0;
+    bool resizeField = true;
 
     QSize tileSize;
     int maxMineCount = 0;
 
     QSize baseSize;
+    QMetaObject::Connection dpiConnection;
 
     bool finished = false;
+    bool ranked = true;         // a standard board the player started
     QTimer timer;
+    QTimer refresh;             // coalesces the updates of a bot playing
 };
 
 #endif // MAINWINDOW_H
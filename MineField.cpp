@@ -1,5 +1,7 @@
 #include "MineField.h"
 #include "MineSweeper.h"
+#include "GLViewport.h"
+#include "RevealScheduler.h"
 
 MineField::MineField(QWidget* parent)
     : QGraphicsView(parent)
@@ -7,7 +9,14 @@ MineField::MineField(QWidget* parent)
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setScene(&scene);
-    logic = MineSweeper::instance();
+    setCacheMode(QGraphicsView::CacheBackground);
+
+    clock.start();
+    moveTimer.setSingleShot(true);
+    connect(&moveTimer, &QTimer::timeout,
+            this, &MineField::flushMove);
+
+    reveal = new RevealScheduler(this);
 }
 
 MineField::~MineField()
@@ -16,37 +25,120 @@ MineField::~MineField()
         scene.removeItem(item);
 }
 
+MineSweeper* MineField::getLogic() const
+{
+    return logic;
+}
+
+void MineField::setLogic(MineSweeper* newLogic)
+{
+    // tiles belong to the game they were created for
+    if(logic)
+    {
+        disconnect(logic, nullptr, reveal, nullptr);
+        disconnect(logic, nullptr, this, nullptr);
+    }
+    reveal->clear();
+    tiles.clear();
+    logic = newLogic;
+    connect(logic, &MineSweeper::revealed,
+            reveal, &RevealScheduler::schedule);
+    // undo, redo and bot moves change tiles without a mouse event on them
+    connect(logic, &MineSweeper::played,
+            this, [this]() { viewport()->update(); });
+}
+
+qreal MineField::getTileSize() const
+{
+    return tileSize;
+}
+
+void MineField::setTileSize(qreal size)
+{
+    tileSize = size;
+}
+
+const QVector<QVector<QSharedPointer<Tile> > >& MineField::getTiles() const
+{
+    return tiles;
+}
+
 void MineField::init()
 {
     QFont f = font();
-    f.setPixelSize(Tile::size() * 4 / 5);
+    f.setPixelSize(tileSize * 4 / 5);
     setFont(f);
 }
 
+bool MineField::isOpenGL() const
+{
+    return qobject_cast<GLViewport*>(viewport());
+}
+
+void MineField::setOpenGL(bool enabled)
+{
+    if(enabled == isOpenGL())
+        return;
+
+    if(enabled)
+    {
+        // the whole board is redrawn in one instanced draw call
+        setViewport(new GLViewport());
+        setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+        setCacheMode(QGraphicsView::CacheNone);
+    }
+    else
+    {
+        setViewport(new QWidget());
+        setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+        setCacheMode(QGraphicsView::CacheBackground);
+    }
+}
+
 void MineField::started()
 {
     setEnabled(true);
+    reveal->clear();
 
-    QSize size = logic->getTileSize();
-    setFixedSize(size.width() * Tile::size(),
-                 size.height() * Tile::size());
+    // hexagonal boards shift odd rows right by half a tile
+    bool hexagonal = (logic->getTopology() == Topology::Hexagonal);
+    Grid grid = logic->getGrid();
+    QSizeF size(grid.columns, grid.rows);
+    if(hexagonal)
+        size.rwidth() += 0.5;
+    setFixedSize(qCeil(size.width() * tileSize),
+                 qCeil(size.height() * tileSize));
 
-    Q_FOREACH(auto item, scene.items())
-        scene.removeItem(item);
-    auto tiles = logic->getTiles();
     scene.setSceneRect(0,
                        0,
-                       size.width() * Tile::size(),
-                       size.height() * Tile::size());
-    Q_FOREACH(auto row, tiles)
+                       size.width() * tileSize,
+                       size.height() * tileSize);
+
+    // reuse tiles of the previous game, only grow or shrink by the delta.
+    // dropped tiles leave the scene when they are deleted
+    Cell* cells = logic->getCells();
+    tiles.resize(grid.rows);
+    for(int r=0;r<grid.rows;++r)
     {
-        Q_FOREACH(auto tile, row)
+        QVector<QSharedPointer<Tile> >& line = tiles[r];
+        line.resize(grid.columns);
+        for(int c=0;c<grid.columns;++c)
         {
-            scene.addItem(tile.data());
-            tile->setPos(tile->index().x() * Tile::size(),
-                         tile->index().y() * Tile::size());
+            QSharedPointer<Tile>& tile = line[c];
+            if(!tile)
+            {
+                tile = QSharedPointer<Tile>::create(logic);
+                tile->setIndex(QPoint(c, r));
+                scene.addItem(tile.data());
+            }
+            tile->setCell(cells + grid.index(c, r));
+            tile->setSize(tileSize);
+            qreal shift = (hexagonal && (r & 1)) ? 0.5 : 0;
+            tile->setPos((c + shift) * tileSize, r * tileSize);
         }
     }
+    resetCachedContent();
+    viewport()->update();
 }
 
 void MineField::success()
@@ -59,39 +151,183 @@ void MineField::explode()
     setEnabled(false);
 }
 
-void MineField::mouseMoveEvent(QMouseEvent* event)
+void MineField::paintEvent(QPaintEvent* event)
 {
-    auto tile = dynamic_cast<Tile*>(scene.itemAt(event->pos(), QTransform()));
-    if(!tile)
-        return;
-    if(event->buttons().testFlag(Qt::MidButton))
+    // painting time paces the reveal
+    qint64 start = clock.nsecsElapsed();
+    QGraphicsView::paintEvent(event);
+    qint64 end = clock.nsecsElapsed();
+    reveal->framePainted(end - start);
+
+    // input handled before this frame is on screen now, unless the frame
+    // left out the tiles it changed
+    for(int i=0;i<InputCount;++i)
     {
-        logic->moveHover(tile->index());
+        if((received[i] < 0) || !event->region().intersects(target[i]))
+            continue;
+        latency[i].record(end - received[i]);
+        received[i] = -1;
+        target[i] = QRegion();
+    }
+}
+
+void MineField::drawBackground(QPainter* painter, const QRectF& rect)
+{
+    auto gl = qobject_cast<GLViewport*>(viewport());
+    if(gl && gl->isBatching())
+    {
+        painter->beginNativePainting();
+        bool drawn = gl->drawTiles(tiles,
+                                   tileSize,
+                                   logic->getState() != MineSweeper::State::Running,
+                                   viewportTransform(),
+                                   palette(),
+                                   font());
+        painter->endNativePainting();
+        if(drawn)
+            return;
+
+        // batching is not supported, let tiles paint themselves
         viewport()->update();
     }
-    QGraphicsView::mouseMoveEvent(event);
+    QGraphicsView::drawBackground(painter, rect);
+
+    // covered look of every tile, cached by the view until the board changes
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    Q_FOREACH(auto row, tiles)
+    {
+        Q_FOREACH(auto tile, row)
+        {
+            if(!tile->sceneBoundingRect().intersects(rect))
+                continue;
+            painter->translate(tile->pos());
+            Tile::paintBackground(painter, tile->boundingRect().toRect(), tile->index(), palette());
+            painter->translate(-tile->pos());
+        }
+    }
+    painter->restore();
+}
+
+void MineField::mouseMoveEvent(QMouseEvent* event)
+{
+    // keep the latest move only, it is handled once per frame. Moves within
+    // a tile change no pixels and are not measured
+    QRect area = tileArea(event->pos());
+    if(area != hovered)
+    {
+        if(received[Input::Move] < 0)
+            received[Input::Move] = clock.nsecsElapsed();
+        target[Input::Move] += QRegion(area) + hovered;
+        hovered = area;
+    }
+    movePending = true;
+    moveLocal = event->localPos();
+    moveScreen = event->screenPos();
+    moveButtons = event->buttons();
+    moveModifiers = event->modifiers();
+    if(!moveTimer.isActive())
+        moveTimer.start(qMax<qint64>(0, 16 - (clock.nsecsElapsed() - lastMove) / 1000000));
 }
 
 void MineField::mousePressEvent(QMouseEvent* event)
 {
+    flushMove();
+    received[input(event->button())] = clock.nsecsElapsed();
+    target[input(event->button())] = tileArea(event->pos());
+
     QGraphicsView::mousePressEvent(event);
     if(event->button() == Qt::MidButton)
     {
         auto tile = dynamic_cast<Tile*>(scene.itemAt(event->pos(), QTransform()));
-        logic->moveHover(tile->index());
+        if(tile)
+            logic->moveHover(tile->index());
     }
     emit press();
-    viewport()->repaint();
+    viewport()->update();
 }
 
 void MineField::mouseReleaseEvent(QMouseEvent* event)
 {
+    flushMove();
+    received[input(event->button())] = clock.nsecsElapsed();
+    target[input(event->button())] = tileArea(event->pos());
+
     QGraphicsView::mouseReleaseEvent(event);
     if(event->button() == Qt::MidButton)
     {
         auto tile = dynamic_cast<Tile*>(scene.itemAt(event->pos(), QTransform()));
-        logic->setPressed(tile->index(), Qt::MidButton, false);
+        if(tile)
+            logic->setPressed(tile->index(), Qt::MidButton, false);
     }
     emit release();
-    viewport()->repaint();
+    viewport()->update();
+}
+
+void MineField::flushMove()
+{
+    moveTimer.stop();
+    if(!movePending)
+        return;
+
+    movePending = false;
+    lastMove = clock.nsecsElapsed();
+    QMouseEvent event(QEvent::MouseMove, moveLocal, moveLocal, moveScreen,
+                      Qt::NoButton, moveButtons, moveModifiers);
+
+    auto tile = dynamic_cast<Tile*>(scene.itemAt(event.pos(), QTransform()));
+    if(tile && event.buttons().testFlag(Qt::MidButton))
+    {
+        logic->moveHover(tile->index());
+        viewport()->update();
+    }
+    QGraphicsView::mouseMoveEvent(&event);
+}
+
+MineField::Input MineField::input(Qt::MouseButton button)
+{
+    switch(button)
+    {
+    case Qt::LeftButton:
+        return Input::Left;
+    case Qt::MidButton:
+        return Input::Middle;
+    case Qt::RightButton:
+        return Input::Right;
+    default:
+        break;
+    }
+    return Input::Move;
+}
+
+QRect MineField::tileArea(const QPoint& pos) const
+{
+    auto tile = dynamic_cast<Tile*>(scene.itemAt(pos, QTransform()));
+    if(!tile)
+        return QRect();
+    return mapFromScene(tile->sceneBoundingRect()).boundingRect();
+}
+
+const LatencyHistogram& MineField::getLatency(Qt::MouseButton button) const
+{
+    return latency[input(button)];
+}
+
+QString MineField::latencyReport() const
+{
+    const char* names[InputCount] = {"left", "middle", "right", "move"};
+    QStringList lines;
+    for(int i=0;i<InputCount;++i)
+        lines << QStringLiteral("%1  %2").arg(QString::fromLatin1(names[i]), -6).arg(latency[i].summary());
+    return lines.join(QLatin1Char('\n'));
+}
+
+void MineField::clearLatency()
+{
+    for(int i=0;i<InputCount;++i)
+    {
+        latency[i].clear();
+        received[i] = -1;
+        target[i] = QRegion();
+    }
 }
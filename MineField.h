@@ -2,9 +2,11 @@
 #define MINEFIELD_H
 
 #include <QtWidgets>
+#include "LatencyHistogram.h"
 
 class Tile;
 class MineSweeper;
+class RevealScheduler;
 class MineField : public QGraphicsView
 {
     Q_OBJECT
@@ -16,21 +18,65 @@ public:
     Q_SIGNAL void press();
     Q_SIGNAL void release();
 
+    MineSweeper* getLogic() const;
+    void setLogic(MineSweeper* logic);
+    qreal getTileSize() const;
+    void setTileSize(qreal size);
+    const QVector<QVector<QSharedPointer<Tile> > >& getTiles() const;
+
     void init();
+    bool isOpenGL() const;
+    void setOpenGL(bool enabled);
     void started();
     void success();
     void explode();
 
+    // event to pixel latency per button, Qt::NoButton for hover moves.
+    // measured from event delivery to the end of the first paint covering
+    // the tiles the event changed
+    const LatencyHistogram& getLatency(Qt::MouseButton button) const;
+    QString latencyReport() const;
+    void clearLatency();
+
 protected:
+    void paintEvent(QPaintEvent* event) override final;
+    void drawBackground(QPainter* painter, const QRectF& rect) override final;
     void mouseMoveEvent(QMouseEvent* event) override final;
     void mousePressEvent(QMouseEvent* event) override final;
     void mouseReleaseEvent(QMouseEvent* event) override final;
 
 private:
-    MineSweeper* logic;
+    enum Input {
+        Left = 0,
+        Middle,
+        Right,
+        Move,
+        InputCount
+    };
+
+    Q_SLOT void flushMove();
+    static Input input(Qt::MouseButton button);
+    QRect tileArea(const QPoint& pos) const;
+
+    MineSweeper* logic = nullptr;
+    qreal tileSize = 32;
+    QVector<QVector<QSharedPointer<Tile> > > tiles;   // reused between games
     QGraphicsScene scene;
+    RevealScheduler* reveal;
     Qt::MouseButton button = Qt::NoButton;
     QPoint pressPos;
+    QElapsedTimer clock;
+    QTimer moveTimer;                       // delivers the coalesced move
+    bool movePending = false;               // the latest move, not handled yet
+    QPointF moveLocal;
+    QPointF moveScreen;
+    Qt::MouseButtons moveButtons;
+    Qt::KeyboardModifiers moveModifiers;
+    qint64 lastMove = 0;
+    qint64 received[InputCount] = {-1, -1, -1, -1};    // unpainted input per kind
+    QRegion target[InputCount];             // viewport area of its tiles
+    QRect hovered;                          // viewport area of the tile under the pointer
+    LatencyHistogram latency[InputCount];
 };
 
 #endif // MINEFIELD_H
@@ -1,114 +1,69 @@
 #include "MineSweeper.h"
-#include <QtWidgets>
+#include "BoardGenerator.h"
+#include "BoardSnapshot.h"
+#include <algorithm>
 #include <utility>
 
-Q_GLOBAL_STATIC(MineSweeper, mc)
-
-MineSweeper::MineSweeper()
+MineSweeper::MineSweeper(QObject* parent)
+    : QObject(parent)
 {
     setObjectName(QStringLiteral("mineSweep"));
-
-    settings = new QSettings(QDir(qApp->applicationDirPath()).absoluteFilePath("MineSweep.ini"),
-                             QSettings::IniFormat, dynamic_cast<QObject*>(this));
-
-    // function for loading ranklist with given level
-    auto loadRank = [this](Difficulty level)
-    {
-        QList<QVariantList> list;
-        settings->beginReadArray(QStringLiteral("Rank"));
-        for(int i=0;i<10;++i)
-        {
-            settings->setArrayIndex(i);
-            QVariantList value;
-            int r = settings->value(QStringLiteral("rank"), i+1).toInt();
-            QString name = settings->value(QStringLiteral("name"),
-                                           QStringLiteral("anoymous"))
-                           .toString();
-            qreal time = settings->value(QStringLiteral("time"),
-                                         999).toReal();
-            value << r << name << time;
-            list.append(value);
-        }
-        settings->endArray();
-        ranklist[level] = list;
-    };
-
-    // load simple ranklist
-    settings->beginGroup(QStringLiteral("Simple"));
-    loadRank(Difficulty::Simple);
-    settings->endGroup();
-
-    // load normal ranklist
-    settings->beginGroup(QStringLiteral("Normal"));
-    loadRank(Difficulty::Normal);
-    settings->endGroup();
-
-    // load hard ranklist
-    settings->beginGroup(QStringLiteral("Hard"));
-    loadRank(Difficulty::Hard);
-    settings->endGroup();
 }
 
 MineSweeper::~MineSweeper()
 {
-    // function for saving ranklist with given level
-    auto saveRank = [this](Difficulty level)
-    {
-        QList<QVariantList> list = ranklist[level];
-        settings->beginWriteArray(QStringLiteral("Rank"));
-        for(int i=0;i<10;++i)
-        {
-            settings->setArrayIndex(i);
-            QVariantList value = list.at(i);
-            settings->setValue(QStringLiteral("rank"), value.at(0).toInt());
-            settings->setValue(QStringLiteral("name"), value.at(1).toString());
-            settings->setValue(QStringLiteral("time"), value.at(2).toReal());
-        }
-        settings->endArray();
-    };
+}
 
-    // save simple ranklist
-    settings->beginGroup(QStringLiteral("Simple"));
-    saveRank(Difficulty::Simple);
-    settings->endGroup();
+bool MineSweeper::isScreenHorizontal() const
+{
+    return screenHorizontal;
+}
 
-    // save normal ranklist
-    settings->beginGroup(QStringLiteral("Normal"));
-    saveRank(Difficulty::Normal);
-    settings->endGroup();
+void MineSweeper::setScreenHorizontal(bool horizontal)
+{
+    if(horizontal != screenHorizontal)
+        std::swap(columnRange, rowRange);
+    screenHorizontal = horizontal;
+}
 
-    // save hard ranklist
-    settings->beginGroup(QStringLiteral("Hard"));
-    saveRank(Difficulty::Hard);
-    settings->endGroup();
+bool MineSweeper::isAutoChord() const
+{
+    return autoChord;
+}
 
-    // save ranklist
-    settings->sync();
+void MineSweeper::setAutoChord(bool enabled)
+{
+    autoChord = enabled;
 }
 
-MineSweeper* MineSweeper::instance()
+bool MineSweeper::isHeadless() const
 {
-    return mc;
+    return headless;
 }
 
-void MineSweeper::init(QMainWindow* mainWindow, QSize minimumSize)
+void MineSweeper::setHeadless(bool enabled)
 {
-    QSize size = qApp->desktop()->availableGeometry(mainWindow).size() * 0.9;
-    size -= minimumSize;
+    headless = enabled;
+}
 
-    screenHorizontal = (size.width() >= size.height());
-    if(!screenHorizontal)
-        std::swap(columnRange, rowRange);
+Topology MineSweeper::getTopology() const
+{
+    return topology;
 }
 
-bool MineSweeper::isScreenHorizontal() const
+void MineSweeper::setTopology(Topology newTopology)
 {
-    return screenHorizontal;
+    topology = newTopology;
 }
 
-const QVector<QVector<QSharedPointer<Tile> > > MineSweeper::getTiles() const
+Grid MineSweeper::getGrid() const
 {
-    return tiles;
+    return grid;
+}
+
+Cell* MineSweeper::getCells() const
+{
+    return cells;
 }
 
 MineSweeper::Difficulty MineSweeper::getDifficulty() const
@@ -136,14 +91,24 @@ int MineSweeper::getMineCount() const
     return mineCount;
 }
 
-int MineSweeper::getRank() const
+int MineSweeper::getRemaining() const
+{
+    return remaining;
+}
+
+const QVector<int>& MineSweeper::getChanged() const
 {
-    return rank;
+    return changed;
 }
 
-QList<QVariantList> MineSweeper::getRank(MineSweeper::Difficulty lvl) const
+const Frontier& MineSweeper::getFrontier() const
 {
-    return ranklist[lvl];
+    return frontier;
+}
+
+BoardStatistics MineSweeper::getStatistics() const
+{
+    return board ? board->statistics : BoardStatistics();
 }
 
 const QPoint MineSweeper::getColumnRange() const
@@ -158,16 +123,29 @@ const QPoint MineSweeper::getRowRange() const
 
 qreal MineSweeper::getTime() const
 {
-    static qreal time;
     if(state == MineSweeper::State::Running)
-        time = timer.elapsed() / static_cast<qreal>(1000);
-    return time;
+        return timer.elapsed() / static_cast<qreal>(1000);
+    return finishTime;
 }
 
-void MineSweeper::startGame(MineSweeper::Difficulty lvl, QSize size, int mines)
+Observation::View MineSweeper::observe() const
+{
+    Observation::View view;
+    view.data = codes;
+    view.columns = grid.columns;
+    view.rows = grid.rows * grid.layers;
+    view.rowStride = grid.columns;
+    return view;
+}
+
+SnapshotPublisher<BoardSnapshot>::Handle MineSweeper::snapshot() const
+{
+    return snapshots.acquire();
+}
+
+void MineSweeper::setupGame(MineSweeper::Difficulty lvl, QSize size, int mines)
 {
     difficulty = lvl;
-    state = MineSweeper::State::Running;
 
     // init columns, rows, mines. columns is larger
     int col = 0;
@@ -202,290 +180,467 @@ void MineSweeper::startGame(MineSweeper::Difficulty lvl, QSize size, int mines)
     if(!screenHorizontal)
         std::swap(col, row);
     tileSize = QSize(col, row);
+}
 
-    // initialize tiles
-    tiles.clear();
-    tiles.resize(row);
-    for(int r=0;r<row;++r)
-    {
-        tiles[r] = QVector<QSharedPointer<Tile> >(col);
-        for(int c=0;c<col;++c)
-        {
-            tiles[r][c] = QSharedPointer<Tile>::create();
-            tiles.at(r).at(c)->setIndex(QPoint(c, r));
-        }
-    }
-
-    // initialize tile neighbours
-    for(int r=0;r<row;++r)
+void MineSweeper::startGame(QSharedPointer<const Board> newBoard)
+{
+    state = MineSweeper::State::Running;
+    board = newBoard;
+    grid = board->grid;
+    tileSize = QSize(grid.columns, grid.rows);
+    maxMineCount = board->mines;
+
+    // state of the previous game is released at once
+    arena.release();
+    cells = arena.create<Cell>(grid.count());
+    for(int i=0;i<grid.count();++i)
     {
-        for(int c=0;c<col;++c)
-        {
-            QSharedPointer<Tile> tile = tiles.at(r).at(c);
-            for(int i=0;i<8;++i)
-            {
-                Direction direction = static_cast<Direction>(i);
-                int nc = c + Directions.value(direction).x();
-                int nr = r + Directions.value(direction).y();
-                if(((nc >= 0) && (nc < col))
-                   && ((nr >= 0) && (nr < row)))
-                {
-                    QSharedPointer<Tile> neighbour = tiles.at(nr).at(nc);
-                    tile->setNeighbour(direction, neighbour);
-                }
-            }
-        }
+        cells[i].isMine = board->isMine.at(i);
+        cells[i].surroundingMines = board->surroundingMines.at(i);
     }
+    markedZeros = arena.create<int>(board->openingOffsets.size());
+    flags = arena.create<quint8>(grid.count());
+    chorded = arena.create<quint32>(grid.count());
+    cascades = 0;
+    publishing = !headless;
+    journal.setEnabled(!headless);
+    codes = arena.create<quint8>(grid.count());
+    std::fill(codes, codes + grid.count(), static_cast<quint8>(Observation::Covered));
+    remaining = grid.count() - maxMineCount;
+    chordIndex = -1;
+    frontier.reset(grid, arena);
 
-    // initialize mines
-    mineCount = maxMineCount;
-    while(mineCount > 0)
-    {
-        int r = qrand()%row;
-        int c = qrand()%col;
-        QSharedPointer<Tile> tile = tiles.at(r).at(c);
-        if(tile->isMine())
-            continue;
-        tile->setIsMine(true);
-        --mineCount;
-    }
     mineCount = maxMineCount;
 
-    // initialize tile surrounding mine count
-    for(int r=0;r<row;++r)
-    {
-        for(int c=0;c<col;++c)
-        {
-            QSharedPointer<Tile> tile = tiles.at(r).at(c);
-            quint8 count = tile->surroundingMines();
-            for(int i=0;i<8;++i)
-            {
-                Direction direction = static_cast<Direction>(i);
-                int nc = c + Directions.value(direction).x();
-                int nr = r + Directions.value(direction).y();
-                if(((nc >= 0) && (nc < col))
-                   && ((nr >= 0) && (nr < row)))
-                {
-                    QSharedPointer<Tile> neighbour = tiles.at(nr).at(nc);
-                    count += (neighbour->isMine()?1:0);
-                }
-            }
-            tile->setSurroundingMines(count);
-        }
-    }
+    // all pages start out sharing one covered page
+    int pageCount = (grid.count() + BoardSnapshot::PageSize - 1) / BoardSnapshot::PageSize;
+    if(publishing)
+        pages = QVector<BoardSnapshot::Page>(pageCount, BoardSnapshot::Page(BoardSnapshot::PageSize,
+                                                                            Tile::Cover));
+    else
+        pages.clear();
+    changed.resize(0);
+    publish();
 
     emit update();
     timer.restart();
 }
 
+void MineSweeper::startGame(MineSweeper::Difficulty lvl, QSize size, int mines)
+{
+    setupGame(lvl, size, mines);
+    startGame(BoardGenerator::generate(Grid(tileSize.width(), tileSize.height(), 1, topology),
+                                       maxMineCount, qrand()));
+}
+
 bool MineSweeper::isPressed(const QPoint& index, Qt::MouseButton button) const
 {
-    QSharedPointer<Tile> tile = tiles.at(index.y()).at(index.x());
-    return tile->isPressed(button);
+    return cells[grid.index(index)].isPressed(button);
 }
 
 void MineSweeper::setPressed(const QPoint& index, Qt::MouseButton button, bool pressed)
 {
-    QSharedPointer<Tile> tile = tiles.at(index.y()).at(index.x());
+    int i = grid.index(index);
 
     switch(button)
     {
     case Qt::MidButton:
-        for(int i=0;i<8;++i)
+        // only one chord is pressed at a time
+        if(chordIndex >= 0)
         {
-            Direction direction = static_cast<Direction>(i);
-            QSharedPointer<Tile> neighbour = tile->neighbour(direction);
-            if(neighbour)
-                neighbour->setPressed(button, pressed);
+            pressNeighbours(chordIndex, false);
+            cells[chordIndex].setPressed(button, false);
         }
+        chordIndex = pressed ? i : -1;
+        pressNeighbours(i, pressed);
         break;
     case Qt::LeftButton:
     case Qt::RightButton:
     default:
         break;
     }
-    tile->setPressed(button, pressed);
+    cells[i].setPressed(button, pressed);
 }
 
 void MineSweeper::click(const QPoint& index, Qt::MouseButton button)
 {
-    QSharedPointer<Tile> tile = tiles.at(index.y()).at(index.x());
-    if(tile->isPressed(button))
+    int i = grid.index(index);
+    if(cells[i].isPressed(button))
+        play(i, button);
+}
+
+void MineSweeper::play(int index, Qt::MouseButton button)
+{
+    changed.resize(0);
+    journal.begin();
+    switch(button)
     {
-        QSharedPointer<Tile> tile = tiles.at(index.y()).at(index.x());
-        switch(button)
-        {
-        case Qt::LeftButton:
-            leftClick(tile);
-            break;
-        case Qt::MidButton:
-            midClick(tile);
-            break;
-        case Qt::RightButton:
-            rightClick(tile);
-            break;
-        default:
-            break;
-        }
+    case Qt::LeftButton:
+        leftClick(index);
+        break;
+    case Qt::MidButton:
+        midClick(index);
+        break;
+    case Qt::RightButton:
+        rightClick(index);
+        break;
+    default:
+        break;
     }
+    journal.end();
+    if(changed.isEmpty())
+        return;
+    frontier.update(cells, changed);
+    publish();
+    emit played();
 }
 
 void MineSweeper::moveHover(const QPoint& index)
 {
-    Q_FOREACH(auto row, tiles)
-    {
-        Q_FOREACH(auto tile, row)
-            tile->setPressed(Qt::MidButton, false);
-    }
     setPressed(index, Qt::MidButton, true);
 }
 
-void MineSweeper::leftClick(QSharedPointer<Tile> tile)
+bool MineSweeper::canUndo() const
+{
+    return journal.canUndo();
+}
+
+bool MineSweeper::canRedo() const
+{
+    return journal.canRedo();
+}
+
+int MineSweeper::getUndoCount() const
+{
+    return journal.getUndoCount();
+}
+
+void MineSweeper::undo()
+{
+    changed.resize(0);
+    journal.undo([this](Journal::Delta& delta)
+    {
+        Tile::State current = cells[delta.cell].state;
+        restore(delta.cell, static_cast<Tile::State>(delta.state));
+        delta.state = current;
+        changed.append(delta.cell);
+    });
+    if(changed.isEmpty())
+        return;
+
+    // every move starts on a running game
+    state = MineSweeper::State::Running;
+    frontier.update(cells, changed);
+    publish();
+    emit played();
+    emit update();
+}
+
+void MineSweeper::redo()
+{
+    changed.resize(0);
+    bool exploded = false;
+    journal.redo([this, &exploded](Journal::Delta& delta)
+    {
+        Tile::State current = cells[delta.cell].state;
+        exploded = restore(delta.cell, static_cast<Tile::State>(delta.state)) || exploded;
+        delta.state = current;
+        changed.append(delta.cell);
+    });
+    if(changed.isEmpty())
+        return;
+
+    frontier.update(cells, changed);
+    if(exploded)
+        finish(MineSweeper::State::Fail);
+    else
+        checkSuccess();
+    publish();
+    emit played();
+    emit update();
+}
+
+void MineSweeper::leftClick(int index)
 {
     if(state != MineSweeper::State::Running)
         return;
 
-    bool exploded = uncover(tile);
+    bool exploded = uncover(index);
+    if(!exploded && autoChord)
+        exploded = cascade();
     if(exploded)
-    {
-        state = MineSweeper::State::Fail;
-        calcRank();
-        emit explode();
-    }
+        finish(MineSweeper::State::Fail);
     else
-    {
         checkSuccess();
-    }
 
+    emit revealed(index, changed);
     emit update();
 }
 
-void MineSweeper::midClick(QSharedPointer<Tile> tile)
+void MineSweeper::midClick(int index)
 {
     if(state != MineSweeper::State::Running)
         return;
 
-    if(tile->state() != Tile::Uncover)
+    if(cells[index].state != Tile::Uncover)
         return;
 
-    int mineCount = tile->surroundingMines();
-    int count = 0;
-
-    for(int i=0;i<8;++i)
-    {
-        Direction direction = static_cast<Direction>(i);
-        QSharedPointer<Tile> neighbour = tile->neighbour(direction);
-        if(!neighbour)
-            continue;
-        if(neighbour->state() == Tile::Flag)
-            ++count;
-    }
-
-    if(count != mineCount)
+    if(flags[index] != cells[index].surroundingMines)
         return;
 
-    bool exploded = uncover(tile);
-    for(int i=0;i<8;++i)
+    bool exploded = uncover(index);
+    grid.forEachNeighbour(index, [this, &exploded](int neighbour)
     {
-        Direction direction = static_cast<Direction>(i);
-        QSharedPointer<Tile> neighbour = tile->neighbour(direction);
-        if(!neighbour)
-            continue;
-        if(neighbour->state() == Tile::Cover)
+        if(cells[neighbour].state == Tile::Cover)
             exploded = exploded || uncover(neighbour);
-    }
+    });
+    if(!exploded && autoChord)
+        exploded = cascade();
 
     if(exploded)
-    {
-        state = MineSweeper::State::Fail;
-        calcRank();
-        emit explode();
-    }
+        finish(MineSweeper::State::Fail);
     else
-    {
         checkSuccess();
-    }
+
+    emit revealed(index, changed);
 }
 
-void MineSweeper::rightClick(QSharedPointer<Tile> tile)
+void MineSweeper::rightClick(int index)
 {
     if(state != MineSweeper::State::Running)
         return;
 
-    switch(tile->state())
+    Cell& cell = cells[index];
+    int opening = board->opening.at(index);
+    Tile::State previous = cell.state;
+    switch(cell.state)
     {
     case Tile::Cover:
-        tile->setState(Tile::Flag);
+        cell.state = Tile::Flag;
         mineCount -= 1;
+        flagNeighbours(index, 1);
+        if(opening >= 0)
+            ++markedZeros[opening];
         break;
     case Tile::Flag:
-        tile->setState(Tile::Tag);
+        cell.state = Tile::Tag;
         mineCount += 1;
+        flagNeighbours(index, -1);
         break;
     case Tile::Tag:
-        tile->setState(Tile::Cover);
+        cell.state = Tile::Cover;
+        if(opening >= 0)
+            --markedZeros[opening];
         break;
     case Tile::Explode:
     case Tile::Uncover:
-        break;
+        return;
+    }
+    journal.record(index, previous);
+    changed.append(index);
+
+    // a flag may satisfy the numbers around it
+    if(autoChord)
+    {
+        if(cascade())
+            finish(MineSweeper::State::Fail);
+        else
+            checkSuccess();
+        emit revealed(index, changed);
+    }
+    else
+    {
+        checkSuccess();
     }
-    checkSuccess();
 
     emit update();
 }
 
-bool MineSweeper::uncover(QSharedPointer<Tile> tile)
+bool MineSweeper::uncover(int index)
 {
     // already uncovered
-    if(tile->state() != Tile::Cover)
+    if(cells[index].state != Tile::Cover)
         return false;
 
-    // uncover tile
-    tile->setState(Tile::Uncover);
-
     // detect mine
-    if(tile->isMine())
+    if(cells[index].isMine)
     {
-        tile->setState(Tile::Explode);
+        cells[index].state = Tile::Explode;
+        journal.record(index, Tile::Cover);
+        changed.append(index);
         return true;
     }
 
-    // if surrounding mine count is not zero, do not uncover neighbours
-    if(tile->surroundingMines() != 0)
+    // a zero tile reveals its precomputed opening, unless a flag inside
+    // cuts it short. Border numbers are part of the spans
+    int opening = board->opening.at(index);
+    if((opening >= 0) && (markedZeros[opening] == 0))
+    {
+        const Board::Span* spans = board->openingSpans.constData();
+        for(int s=board->openingOffsets.at(opening);s<board->openingOffsets.at(opening + 1);++s)
+        {
+            for(int i=spans[s].begin;i<spans[s].end;++i)
+            {
+                if(cells[i].state != Tile::Cover)
+                    continue;
+                cells[i].state = Tile::Uncover;
+                --remaining;
+                journal.record(i, Tile::Cover);
+                changed.append(i);
+            }
+        }
         return false;
+    }
+
+    // uncover tile, and flood the zero area with an explicit stack,
+    // recursion overflows on large boards. neighbours of a zero are no mines
+    cells[index].state = Tile::Uncover;
+    --remaining;
+    journal.record(index, Tile::Cover);
+    changed.append(index);
+    pending.resize(0);
+    pending.append(index);
+    while(!pending.isEmpty())
+    {
+        int current = pending.takeLast();
+        if(cells[current].surroundingMines != 0)
+            continue;
+
+        grid.forEachNeighbour(current, [this](int neighbour)
+        {
+            Cell& cell = cells[neighbour];
+            if(cell.state != Tile::Cover)
+                return;
+            cell.state = Tile::Uncover;
+            --remaining;
+            journal.record(neighbour, Tile::Cover);
+            changed.append(neighbour);
+            pending.append(neighbour);
+        });
+    }
+    return false;
+}
 
+bool MineSweeper::cascade()
+{
+    // changed is the worklist: every changed tile offers itself and its
+    // neighbours. Flags stay put meanwhile, so a number is checked only once
+    ++cascades;
     bool exploded = false;
-    for(int i=0;i<8;++i)
+    auto check = [this, &exploded](int number)
+    {
+        const Cell& cell = cells[number];
+        if((cell.state != Tile::Uncover) || (cell.surroundingMines == 0)
+           || (chorded[number] == cascades))
+            return;
+        chorded[number] = cascades;
+        if(flags[number] != cell.surroundingMines)
+            return;
+        grid.forEachNeighbour(number, [this, &exploded](int neighbour)
+        {
+            if(cells[neighbour].state == Tile::Cover)
+                exploded = exploded || uncover(neighbour);
+        });
+    };
+    for(int i=0;(i<changed.size()) && !exploded;++i)
     {
-        Direction direction = static_cast<Direction>(i);
-        QSharedPointer<Tile> neighbour = tile->neighbour(direction);
-        if(neighbour)
-            exploded = (exploded || uncover(neighbour));
+        int index = changed.at(i);
+        check(index);
+        grid.forEachNeighbour(index, check);
     }
     return exploded;
 }
 
-void MineSweeper::calcRank()
+void MineSweeper::flagNeighbours(int index, int delta)
 {
-    qreal time = getTime();
+    grid.forEachNeighbour(index, [this, delta](int neighbour)
+    {
+        flags[neighbour] += delta;
+    });
 }
 
-void MineSweeper::checkSuccess()
+bool MineSweeper::restore(int index, Tile::State next)
 {
-    bool onlyMineLeft = true;
-    Q_FOREACH(auto row, tiles)
+    // counters follow the tile out of its state and into the next one
+    Cell& cell = cells[index];
+    int opening = board->opening.at(index);
+    auto account = [&](Tile::State tile, int sign)
     {
-        Q_FOREACH(auto tile, row)
+        if(tile == Tile::Uncover)
+            remaining -= sign;
+        if(tile == Tile::Flag)
         {
-            if((tile->state() != Tile::Uncover) && (!tile->isMine()))
-                onlyMineLeft = false;
+            mineCount -= sign;
+            flagNeighbours(index, sign);
         }
-    }
+        if(((tile == Tile::Flag) || (tile == Tile::Tag)) && (opening >= 0))
+            markedZeros[opening] += sign;
+    };
+    account(cell.state, -1);
+    account(next, 1);
+    cell.state = next;
+    return next == Tile::Explode;
+}
 
-    if(onlyMineLeft)
+void MineSweeper::pressNeighbours(int index, bool pressed)
+{
+    grid.forEachNeighbour(index, [this, pressed](int neighbour)
+    {
+        cells[neighbour].setPressed(Qt::MidButton, pressed);
+    });
+}
+
+void MineSweeper::revealMines()
+{
+    // covered mines are drawn once the game is over
+    for(int i=0;i<grid.count();++i)
     {
-        state = MineSweeper::State::Success;
-        calcRank();
+        if(cells[i].isMine && (cells[i].state == Tile::Cover))
+            changed.append(i);
+    }
+}
+
+void MineSweeper::finish(MineSweeper::State result)
+{
+    state = result;
+    finishTime = timer.elapsed() / static_cast<qreal>(1000);
+    revealMines();
+    if(state == MineSweeper::State::Success)
         emit success();
+    else
+        emit explode();
+}
+
+void MineSweeper::checkSuccess()
+{
+    if(remaining == 0)
+        finish(MineSweeper::State::Success);
+}
+
+void MineSweeper::publish()
+{
+    for(int i=0;i<changed.size();++i)
+    {
+        int index = changed.at(i);
+        codes[index] = Observation::code(cells[index]);
+    }
+    if(!publishing)
+        return;
+
+    // copy on write: only pages holding a changed tile are detached
+    for(int i=0;i<changed.size();++i)
+    {
+        int index = changed.at(i);
+        pages[index >> BoardSnapshot::PageBits][index & (BoardSnapshot::PageSize - 1)]
+                = cells[index].state;
     }
+
+    BoardSnapshot snapshot;
+    snapshot.version = ++version;
+    snapshot.state = state;
+    snapshot.mineCount = mineCount;
+    snapshot.remaining = remaining;
+    snapshot.board = board;
+    snapshot.pages = pages;
+    snapshots.publish(std::move(snapshot));
 }
@@ -3,9 +3,17 @@
 
 #include <QtCore/QtCore>
 #include "Tile.h"
+#include "Board.h"
+#include "Arena.h"
+#include "Observation.h"
+#include "Frontier.h"
+#include "Journal.h"
+#include "SnapshotPublisher.h"
 
-class QMainWindow;
-class MineSweeperPrivate;
+struct BoardSnapshot;
+// One game. Instances are independent and confined to the thread they live
+// in, only snapshot() may be called from other threads. A headless engine
+// may be handed to a worker thread while its owner waits for it
 class MineSweeper : public QObject
 {
     Q_OBJECT
@@ -23,58 +31,115 @@ public:
         Fail
     };
 
-    MineSweeper();
+    explicit MineSweeper(QObject* parent = 0);
     ~MineSweeper();
 
-    static MineSweeper* instance();
-
     Q_SIGNAL void success();
     Q_SIGNAL void explode();
     Q_SIGNAL void update();
+    // tiles whose look changed by a click, the view may paint them progressively
+    Q_SIGNAL void revealed(int origin, const QVector<int>& cells);
+    // a play() changed tiles, they are listed by getChanged()
+    Q_SIGNAL void played();
 
-    void init(QMainWindow* mainWindow, QSize minimumSize);
-
+    // a vertical screen gets boards with more rows than columns
     bool isScreenHorizontal() const;
-    const QVector<QVector<QSharedPointer<Tile> > > getTiles() const;
+    void setScreenHorizontal(bool horizontal);
+    // numbers with as many flags around open their other neighbours by
+    // themselves, on and on
+    bool isAutoChord() const;
+    void setAutoChord(bool enabled);
+    // for bots and batches: no snapshots and no undo history, only the
+    // Observation codes are kept. Takes effect with the next game
+    bool isHeadless() const;
+    void setHeadless(bool enabled);
+    Topology getTopology() const;
+    void setTopology(Topology topology);
+    Grid getGrid() const;
+    Cell* getCells() const;
     Difficulty getDifficulty() const;
     State getState() const;
     QSize getTileSize() const;
     int getMaxMineCount() const;
     int getMineCount() const;
-    int getRank() const;
-    QList<QVariantList> getRank(Difficulty difficulty) const;
+    int getRemaining() const;
+    // tiles changed by the last play()
+    const QVector<int>& getChanged() const;
+    // covered cells next to numbers and the numbers next to them, kept up to date
+    const Frontier& getFrontier() const;
+    BoardStatistics getStatistics() const;
     const QPoint getColumnRange() const;
     const QPoint getRowRange() const;
     qreal getTime() const;
+    // player visible board, Observation codes. Valid until the next game
+    Observation::View observe() const;
+    // latest published position, lock free from any thread. Headless games
+    // publish nothing
+    SnapshotPublisher<BoardSnapshot>::Handle snapshot() const;
 
+    void setupGame(Difficulty difficulty = Difficulty::Simple, QSize size = QSize(), int mines = 0);
+    void startGame(QSharedPointer<const Board> board);
     void startGame(Difficulty difficulty = Difficulty::Simple, QSize size = QSize(), int mines = 0);
 
     bool isPressed(const QPoint& index, Qt::MouseButton button) const;
     void setPressed(const QPoint& index, Qt::MouseButton button, bool pressed);
     void click(const QPoint& index, Qt::MouseButton button);
+    void play(int index, Qt::MouseButton button);
     void moveHover(const QPoint& index);
 
+    // unlimited, a finished game is running again after undo
+    bool canUndo() const;
+    bool canRedo() const;
+    int getUndoCount() const;
+    void undo();
+    void redo();
+
 private:
-    void leftClick(QSharedPointer<Tile> tile);
-    void midClick(QSharedPointer<Tile> tile);
-    void rightClick(QSharedPointer<Tile> tile);
-    bool uncover(QSharedPointer<Tile> tile);
-    void calcRank();
+    void leftClick(int index);
+    void midClick(int index);
+    void rightClick(int index);
+    bool uncover(int index);
+    bool cascade();
+    void flagNeighbours(int index, int delta);
+    bool restore(int index, Tile::State next);
+    void pressNeighbours(int index, bool pressed);
+    void revealMines();
+    void finish(State result);
     void checkSuccess();
+    void publish();
 
     bool screenHorizontal = true;
-    QVector<QVector<QSharedPointer<Tile> > > tiles;
+    Topology topology = Topology::Square;
+    Arena arena;                // per game state, released in one go by the next game
+    QSharedPointer<const Board> board;
+    Grid grid;
+    Cell* cells = nullptr;      // row major, allocated from arena
+    int* markedZeros = nullptr; // flagged or tagged zero tiles per opening
+    quint8* flags = nullptr;    // flagged neighbours per tile
+    quint32* chorded = nullptr; // cascade a number was last checked in
+    quint32 cascades = 0;
+    bool autoChord = false;
+    bool headless = false;
+    bool publishing = true;     // snapshots of the current game, not headless
+    quint8* codes = nullptr;    // Observation code per tile, allocated from arena
+    int remaining = 0;          // covered tiles without mine
+    int chordIndex = -1;        // tile whose neighbours are pressed by the middle button
+    QVector<int> pending;       // flood fill stack of uncover
+    QVector<int> changed;       // tiles changed by the current click
+    Frontier frontier;
+    Journal journal;
+    QVector<QVector<Tile::State> > pages;   // pages of tile states, shared with snapshots
+    quint64 version = 0;
+    SnapshotPublisher<BoardSnapshot> snapshots;
     MineSweeper::Difficulty difficulty = MineSweeper::Difficulty::Simple;
     MineSweeper::State state = MineSweeper::State::Running;
     QSize tileSize;
     int maxMineCount = 0;
     int mineCount = 0;
-    QSettings* settings;
-    int rank;
-    QMap<MineSweeper::Difficulty, QList<QVariantList> > ranklist;
     QPoint columnRange = QPoint(10, 30);
     QPoint rowRange = QPoint(10, 24);
     QElapsedTimer timer;
+    qreal finishTime = 0;       // seconds the finished game took
 };
 
 #endif // MINESWEEPER_H
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT += core widgets
+QT += core widgets concurrent network
 CONFIG += c++14
 
 TARGET = MineSweeper
@@ -16,14 +16,52 @@ SOURCES += main.cpp\
     MineField.cpp \
     MineSweeper.cpp \
     CustomDialog.cpp \
-    Tile.cpp
+    Tile.cpp \
+    GLViewport.cpp \
+    BoardGenerator.cpp \
+    Benchmark.cpp \
+    Arena.cpp \
+    BoardAnalyzer.cpp \
+    RevealScheduler.cpp \
+    LatencyHistogram.cpp \
+    RankList.cpp \
+    BatchEnvironment.cpp \
+    Observation.cpp \
+    BotServer.cpp \
+    Frontier.cpp \
+    BitboardSolver.cpp \
+    PatternSolver.cpp \
+    Journal.cpp \
+    DifficultyEstimator.cpp \
+    TileAssets.cpp
 
 HEADERS += \
     MainWindow.h \
     MineField.h \
     MineSweeper.h \
     CustomDialog.h \
-    Tile.h
+    Tile.h \
+    GLViewport.h \
+    Board.h \
+    BoardGenerator.h \
+    Benchmark.h \
+    Arena.h \
+    Grid.h \
+    BoardAnalyzer.h \
+    RevealScheduler.h \
+    LatencyHistogram.h \
+    TileAssets.h \
+    SnapshotPublisher.h \
+    BoardSnapshot.h \
+    RankList.h \
+    Observation.h \
+    BatchEnvironment.h \
+    BotServer.h \
+    Frontier.h \
+    BitboardSolver.h \
+    PatternSolver.h \
+    Journal.h \
+    DifficultyEstimator.h
 
 FORMS += MainWindow.ui \
     CustomDialog.ui
@@ -0,0 +1,50 @@
+#include "Observation.h"
+
+void Observation::planes(const View& view, quint8* covered, quint8* flagged, quint8* numbers)
+{
+    for(int r=0;r<view.rows;++r)
+    {
+        const quint8* line = view.data + r * view.rowStride;
+        for(int c=0;c<view.columns;++c)
+        {
+            quint8 code = line[c * view.columnStride];
+            *covered++ = (code == Covered) || (code == Flagged) || (code == Tagged);
+            *flagged++ = (code == Flagged);
+            *numbers++ = (code < Covered) ? code : 0;
+        }
+    }
+}
+
+void Observation::pack(const View& view, quint8* packed)
+{
+    // contiguous boards are packed pairwise, others tile by tile
+    if(view.isContiguous())
+    {
+        const int count = view.count();
+        int i = 0;
+        for(;i+1<count;i+=2)
+            *packed++ = view.data[i] | (view.data[i + 1] << 4);
+        if(i < count)
+            *packed = view.data[i];
+        return;
+    }
+
+    int i = 0;
+    for(int r=0;r<view.rows;++r)
+    {
+        for(int c=0;c<view.columns;++c,++i)
+        {
+            quint8 code = view.at(c, r);
+            if(i & 1)
+                *packed++ |= code << 4;
+            else
+                *packed = code;
+        }
+    }
+}
+
+void Observation::unpack(const quint8* packed, int count, quint8* codes)
+{
+    for(int i=0;i<count;++i)
+        codes[i] = (packed[i >> 1] >> ((i & 1) * 4)) & 0x0F;
+}
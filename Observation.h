@@ -0,0 +1,73 @@
+#ifndef OBSERVATION_H
+#define OBSERVATION_H
+
+#include <QtCore/QtCore>
+#include "Tile.h"
+
+// What a player sees of a tile, one byte per tile for bots: the number of
+// an uncovered tile, or one of the covered looks. Mines stay hidden
+class Observation
+{
+public:
+    enum Code : quint8 {
+        Number = 0,     // 0-8, surrounding mines of an uncovered tile
+        Covered = 9,
+        Flagged,
+        Tagged,
+        Exploded,
+        CodeCount
+    };
+
+    // strided read-only view of codes, rows of all layers stacked.
+    // Windows share the data of the view they are taken from
+    struct View
+    {
+        const quint8* data = nullptr;
+        int columns = 0;
+        int rows = 0;
+        int rowStride = 0;      // bytes between rows
+        int columnStride = 1;   // bytes between columns
+
+        int count() const { return columns * rows; }
+        quint8 at(int col, int row) const { return data[row * rowStride + col * columnStride]; }
+        bool isContiguous() const { return (columnStride == 1) && (rowStride == columns); }
+
+        View window(const QRect& rect) const
+        {
+            View view = *this;
+            view.data = data + rect.y() * rowStride + rect.x() * columnStride;
+            view.columns = rect.width();
+            view.rows = rect.height();
+            return view;
+        }
+    };
+
+    static quint8 code(const Cell& cell)
+    {
+        switch(cell.state)
+        {
+        case Tile::Uncover:
+            return Number + cell.surroundingMines;
+        case Tile::Flag:
+            return Flagged;
+        case Tile::Tag:
+            return Tagged;
+        case Tile::Explode:
+            return Exploded;
+        case Tile::Cover:
+            break;
+        }
+        return Covered;
+    }
+
+    // one byte per tile and plane, 0 or 1 for covered (tagged too) and
+    // flagged tiles, the number of uncovered tiles. Planes are row major
+    static void planes(const View& view, quint8* covered, quint8* flagged, quint8* numbers);
+
+    // two codes per byte, the first one in the low nibble
+    static int packedSize(int count) { return (count + 1) / 2; }
+    static void pack(const View& view, quint8* packed);
+    static void unpack(const quint8* packed, int count, quint8* codes);
+};
+
+#endif // OBSERVATION_H
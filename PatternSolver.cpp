@@ -0,0 +1,209 @@
+#include "PatternSolver.h"
+#include "Grid.h"
+
+namespace {
+// A window is four numbers in a line, each 0-3 or None when the tile is no
+// number or has unknown neighbours off the line, and the six tiles of the
+// neighbouring line they touch: tile j is next to numbers j - 2 to j.
+// The table lists the tiles every mine layout agreeing with the numbers
+// leaves free, or fills
+struct PatternTable
+{
+    static constexpr int None = 4;
+    static constexpr int Tiles = 6;
+    static constexpr int Windows = 5 * 5 * 5 * 5 << Tiles;
+
+    static constexpr int key(int n0, int n1, int n2, int n3, int covered)
+    {
+        return ((((n0 * 5 + n1) * 5 + n2) * 5 + n3) << Tiles) | covered;
+    }
+
+    constexpr PatternTable()
+    {
+        // every layout of mines on the covered tiles, against every subset of numbers
+        quint8 possible[Windows] = {};
+        quint8 necessary[Windows] = {};
+        bool seen[Windows] = {};
+        for(int covered=0;covered<(1 << Tiles);++covered)
+        {
+            for(int layout=0;layout<(1 << Tiles);++layout)
+            {
+                if(layout & ~covered)
+                    continue;
+                int sums[4] = {};
+                for(int i=0;i<4;++i)
+                    sums[i] = ((layout >> i) & 1) + ((layout >> (i + 1)) & 1) + ((layout >> (i + 2)) & 1);
+                for(int present=0;present<16;++present)
+                {
+                    int n[4] = {};
+                    for(int i=0;i<4;++i)
+                        n[i] = ((present >> i) & 1)?sums[i]:None;
+                    int w = key(n[0], n[1], n[2], n[3], covered);
+                    possible[w] |= layout;
+                    necessary[w] = seen[w]?(necessary[w] & layout):layout;
+                    seen[w] = true;
+                }
+            }
+        }
+        for(int w=0;w<Windows;++w)
+        {
+            if(!seen[w])
+                continue;
+            safe[w] = (w & ((1 << Tiles) - 1)) & ~possible[w];
+            mines[w] = necessary[w];
+        }
+    }
+
+    quint8 safe[Windows] = {};
+    quint8 mines[Windows] = {};
+};
+
+constexpr PatternTable Table;
+constexpr int None = PatternTable::None;
+
+static_assert(Table.safe[PatternTable::key(1, 1, None, None, 0x3E)] == 0x08,
+              "1-1 against a wall clears the third tile");
+static_assert(Table.mines[PatternTable::key(1, 2, None, None, 0x3E)] == 0x08,
+              "1-2 against a wall has a mine on the third tile");
+static_assert((Table.mines[PatternTable::key(1, 2, 1, None, 0x3F)] == 0x0A)
+              && (Table.safe[PatternTable::key(1, 2, 1, None, 0x3F)] == 0x15),
+              "1-2-1 has mines under the ones");
+static_assert((Table.mines[PatternTable::key(1, 2, 2, 1, 0x3F)] == 0x0C)
+              && (Table.safe[PatternTable::key(1, 2, 2, 1, 0x3F)] == 0x33),
+              "1-2-2-1 has mines under the twos");
+static_assert((Table.safe[PatternTable::key(3, None, None, None, 0x07)] == 0)
+              && (Table.mines[PatternTable::key(3, None, None, None, 0x07)] == 0x07),
+              "a 3 next to three tiles");
+
+enum Mark : quint8 {
+    Safe = 1,
+    Mine = 2
+};
+}
+
+PatternSolver::Result PatternSolver::solve(const Observation::View& view)
+{
+    columns = view.columns;
+    rows = view.rows;
+    windows = 0;
+    int count = columns * rows;
+    unknown.resize(count);
+    around.fill(0, count);
+    value.fill(-1, count);
+    marks.fill(0, count);
+
+    for(int r=0;r<rows;++r)
+    {
+        for(int c=0;c<columns;++c)
+        {
+            quint8 code = view.at(c, r);
+            unknown[r * columns + c] = (code == Observation::Covered) || (code == Observation::Tagged);
+        }
+    }
+    for(int r=0;r<rows;++r)
+    {
+        for(int c=0;c<columns;++c)
+        {
+            int index = r * columns + c;
+            quint8 code = view.at(c, r);
+            if(code >= Observation::Covered)
+                continue;
+            int number = code;
+            for(int d=0;d<DirectionCount;++d)
+            {
+                int col = c + DirectionX[d];
+                int row = r + DirectionY[d];
+                if((col < 0) || (col >= columns) || (row < 0) || (row >= rows))
+                    continue;
+                if(unknown.at(row * columns + col))
+                    around[index] |= 1 << d;
+                else if(view.at(col, row) == Observation::Flagged)
+                    --number;
+            }
+            value[index] = number;
+        }
+    }
+
+    scan(0, -1);
+    scan(0, 1);
+    scan(-1, 0);
+    scan(1, 0);
+
+    Result result;
+    for(int i=0;i<count;++i)
+    {
+        if(marks.at(i) == Safe)
+            result.safe << i;
+        else if(marks.at(i) == Mine)
+            result.mines << i;
+    }
+    return result;
+}
+
+int PatternSolver::getWindows() const
+{
+    return windows;
+}
+
+void PatternSolver::scan(int normalX, int normalY)
+{
+    // numbers usable for this side have unknown neighbours on it only
+    quint8 side = 0;
+    for(int d=0;d<DirectionCount;++d)
+    {
+        if(((normalX != 0) && (DirectionX[d] == normalX))
+           || ((normalY != 0) && (DirectionY[d] == normalY)))
+            side |= 1 << d;
+    }
+
+    bool vertical = (normalY != 0);
+    int lines = vertical?rows:columns;
+    int length = vertical?columns:rows;
+    auto cell = [this, vertical](int line, int pos)
+    {
+        return vertical?(line * columns + pos):(pos * columns + line);
+    };
+    auto code = [&](int line, int pos)
+    {
+        if((pos < 0) || (pos >= length))
+            return None;
+        int index = cell(line, pos);
+        int number = value.at(index);
+        if((number < 0) || (number > 3) || (around.at(index) & ~side))
+            return None;
+        return number;
+    };
+
+    for(int line=0;line<lines;++line)
+    {
+        int next = line + (vertical?normalY:normalX);
+        if((next < 0) || (next >= lines))
+            continue;
+        for(int start=-3;start<length;++start)
+        {
+            int covered = 0;
+            for(int j=0;j<PatternTable::Tiles;++j)
+            {
+                int pos = start - 1 + j;
+                if((pos >= 0) && (pos < length) && unknown.at(cell(next, pos)))
+                    covered |= 1 << j;
+            }
+            if(!covered)
+                continue;
+            int n[4] = {code(line, start), code(line, start + 1),
+                        code(line, start + 2), code(line, start + 3)};
+            if((n[0] == None) && (n[1] == None) && (n[2] == None) && (n[3] == None))
+                continue;
+
+            int w = PatternTable::key(n[0], n[1], n[2], n[3], covered);
+            ++windows;
+            quint8 safe = Table.safe[w];
+            quint8 mines = Table.mines[w];
+            for(int j=0;(safe | mines)>>j;++j)
+            {
+                if((safe | mines) & (1 << j))
+                    marks[cell(next, start - 1 + j)] |= (safe & (1 << j))?Safe:Mine;
+            }
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef PATTERNSOLVER_H
+#define PATTERNSOLVER_H
+
+#include <QtCore/QtCore>
+#include "Observation.h"
+
+// Local deductions along straight borders of covered tiles: 1-1, 1-2, 1-2-1,
+// 1-2-2-1 and whatever else four numbers next to a line of six tiles decide,
+// in all four orientations. Conclusions are looked up in a table generated
+// at compile time, a cheap first pass before a general solver.
+// Square boards only
+class PatternSolver
+{
+public:
+    struct Result
+    {
+        QVector<int> safe;      // ascending
+        QVector<int> mines;     // ascending
+    };
+
+    Result solve(const Observation::View& view);
+    // windows looked up by the last solve
+    int getWindows() const;
+
+private:
+    void scan(int normalX, int normalY);
+
+    int columns = 0;
+    int rows = 0;
+    int windows = 0;
+    QVector<bool> unknown;      // covered or tagged
+    QVector<quint8> around;     // unknown neighbours of a number, bit per Direction
+    QVector<qint8> value;       // number minus flags around, -1 for other tiles
+    QVector<quint8> marks;
+};
+
+#endif // PATTERNSOLVER_H
@@ -0,0 +1,115 @@
+#include "RankList.h"
+
+RankList::RankList(QObject* parent)
+    : QObject(parent)
+{
+    settings = new QSettings(QDir(qApp->applicationDirPath()).absoluteFilePath("MineSweep.ini"),
+                             QSettings::IniFormat, this);
+
+    // function for loading ranklist with given level
+    auto loadRank = [this](MineSweeper::Difficulty level)
+    {
+        QList<QVariantList> list;
+        settings->beginReadArray(QStringLiteral("Rank"));
+        for(int i=0;i<10;++i)
+        {
+            settings->setArrayIndex(i);
+            QVariantList value;
+            int r = settings->value(QStringLiteral("rank"), i+1).toInt();
+            QString name = settings->value(QStringLiteral("name"),
+                                           QStringLiteral("anoymous"))
+                           .toString();
+            qreal time = settings->value(QStringLiteral("time"),
+                                         999).toReal();
+            int bbbv = settings->value(QStringLiteral("bbbv"), 0).toInt();
+            int optimal = settings->value(QStringLiteral("optimal"), 0).toInt();
+            value << r << name << time << bbbv << optimal;
+            list.append(value);
+        }
+        settings->endArray();
+        ranklist[level] = list;
+    };
+
+    // load simple ranklist
+    settings->beginGroup(QStringLiteral("Simple"));
+    loadRank(MineSweeper::Difficulty::Simple);
+    settings->endGroup();
+
+    // load normal ranklist
+    settings->beginGroup(QStringLiteral("Normal"));
+    loadRank(MineSweeper::Difficulty::Normal);
+    settings->endGroup();
+
+    // load hard ranklist
+    settings->beginGroup(QStringLiteral("Hard"));
+    loadRank(MineSweeper::Difficulty::Hard);
+    settings->endGroup();
+}
+
+RankList::~RankList()
+{
+    // function for saving ranklist with given level
+    auto saveRank = [this](MineSweeper::Difficulty level)
+    {
+        QList<QVariantList> list = ranklist[level];
+        settings->beginWriteArray(QStringLiteral("Rank"));
+        for(int i=0;i<10;++i)
+        {
+            settings->setArrayIndex(i);
+            QVariantList value = list.at(i);
+            settings->setValue(QStringLiteral("rank"), value.at(0).toInt());
+            settings->setValue(QStringLiteral("name"), value.at(1).toString());
+            settings->setValue(QStringLiteral("time"), value.at(2).toReal());
+            settings->setValue(QStringLiteral("bbbv"), value.at(3).toInt());
+            settings->setValue(QStringLiteral("optimal"), value.at(4).toInt());
+        }
+        settings->endArray();
+    };
+
+    // save simple ranklist
+    settings->beginGroup(QStringLiteral("Simple"));
+    saveRank(MineSweeper::Difficulty::Simple);
+    settings->endGroup();
+
+    // save normal ranklist
+    settings->beginGroup(QStringLiteral("Normal"));
+    saveRank(MineSweeper::Difficulty::Normal);
+    settings->endGroup();
+
+    // save hard ranklist
+    settings->beginGroup(QStringLiteral("Hard"));
+    saveRank(MineSweeper::Difficulty::Hard);
+    settings->endGroup();
+
+    // save ranklist
+    settings->sync();
+}
+
+QList<QVariantList> RankList::get(MineSweeper::Difficulty difficulty) const
+{
+    return ranklist[difficulty];
+}
+
+int RankList::insert(MineSweeper::Difficulty difficulty, qreal time, int bbbv, int optimal)
+{
+    if(!ranklist.contains(difficulty))
+        return -1;
+
+    // 3BV/s is derived from time and 3BV
+    QList<QVariantList>& list = ranklist[difficulty];
+    int pos = 0;
+    while((pos < list.size()) && (list.at(pos).at(2).toReal() <= time))
+        ++pos;
+    if(pos >= list.size())
+        return -1;
+
+    list.insert(pos, QVariantList() << pos + 1
+                                    << QStringLiteral("anoymous")
+                                    << time
+                                    << bbbv
+                                    << optimal);
+    list.removeLast();
+    for(int i=pos;i<list.size();++i)
+        list[i][0] = i + 1;
+    return pos + 1;
+}
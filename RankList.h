@@ -0,0 +1,28 @@
+#ifndef RANKLIST_H
+#define RANKLIST_H
+
+#include <QtCore/QtCore>
+#include "MineSweeper.h"
+
+// Top ten times of every standard difficulty, kept in MineSweep.ini next to
+// the executable. Entries are rank, name, time, 3BV and the estimated
+// optimal clicks of the board
+class RankList : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RankList(QObject* parent = 0);
+    ~RankList();
+
+    QList<QVariantList> get(MineSweeper::Difficulty difficulty) const;
+
+    // returns the rank of the new entry, -1 when the time is not good enough
+    int insert(MineSweeper::Difficulty difficulty, qreal time, int bbbv, int optimal);
+
+private:
+    QSettings* settings;
+    QMap<MineSweeper::Difficulty, QList<QVariantList> > ranklist;
+};
+
+#endif // RANKLIST_H
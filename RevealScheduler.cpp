@@ -0,0 +1,106 @@
+#include "RevealScheduler.h"
+#include "MineSweeper.h"
+#include "MineField.h"
+
+RevealScheduler::RevealScheduler(MineField* field)
+    : QObject(field)
+    , field(field)
+{
+    // about one tick per frame
+    timer.setInterval(16);
+    connect(&timer, &QTimer::timeout,
+            this, &RevealScheduler::tick);
+}
+
+qint64 RevealScheduler::getBudget() const
+{
+    return budget;
+}
+
+void RevealScheduler::setBudget(qint64 nsecs)
+{
+    budget = nsecs;
+}
+
+bool RevealScheduler::isRevealing() const
+{
+    return next < queue.size();
+}
+
+void RevealScheduler::schedule(int origin, const QVector<int>& cells)
+{
+    // what fits in one frame is shown at once, even during a running reveal
+    if(cells.size() <= perFrame)
+        return;
+
+    // order by ring around the origin with a counting sort
+    Grid grid = field->getLogic()->getGrid();
+    const auto& tiles = field->getTiles();
+    QPoint center = grid.pos(origin);
+    int rings = qMax(grid.columns, grid.rows);
+    QVector<int> offsets(rings + 1, 0);
+    auto ring = [&](int cell)
+    {
+        QPoint pos = grid.pos(cell);
+        return qMax(qAbs(pos.x() - center.x()), qAbs(pos.y() - center.y()));
+    };
+    Q_FOREACH(int cell, cells)
+        ++offsets[ring(cell) + 1];
+    for(int r=0;r<rings;++r)
+        offsets[r + 1] += offsets[r];
+
+    // a new wave queues after the one still running
+    int base = queue.size();
+    queue.resize(base + cells.size());
+    Q_FOREACH(int cell, cells)
+    {
+        queue[base + offsets[ring(cell)]++] = cell;
+        QPoint pos = grid.pos(cell);
+        tiles.at(pos.y()).at(pos.x())->setRevealPending(true);
+    }
+
+    if(!timer.isActive())
+        timer.start();
+}
+
+void RevealScheduler::clear()
+{
+    // tiles drop their pending state when bound to the next game
+    timer.stop();
+    queue.resize(0);
+    next = 0;
+    shown = 0;
+}
+
+void RevealScheduler::framePainted(qint64 nsecs)
+{
+    if(shown == 0)
+        return;
+
+    // scale towards the budget, at most doubling per frame
+    qint64 scaled = perFrame * budget / qMax<qint64>(1, nsecs);
+    perFrame = static_cast<int>(qBound<qint64>(64, scaled, perFrame * 2));
+    shown = 0;
+}
+
+void RevealScheduler::tick()
+{
+    Grid grid = field->getLogic()->getGrid();
+    const auto& tiles = field->getTiles();
+    int end = qMin(queue.size(), next + perFrame);
+    shown = end - next;
+    for(;next<end;++next)
+    {
+        QPoint pos = grid.pos(queue.at(next));
+        auto tile = tiles.at(pos.y()).at(pos.x());
+        tile->setRevealPending(false);
+        tile->update();
+    }
+
+    if(!isRevealing())
+    {
+        timer.stop();
+        queue.resize(0);
+        next = 0;
+    }
+}
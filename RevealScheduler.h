@@ -0,0 +1,37 @@
+#ifndef REVEALSCHEDULER_H
+#define REVEALSCHEDULER_H
+
+#include <QtCore/QtCore>
+
+class MineField;
+// Spreads the painting of large reveals across frames. Revealed tiles keep
+// their covered look and are shown ripple-wise from the click, as many per
+// frame as fit in the painting budget. The game logic is not delayed.
+class RevealScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RevealScheduler(MineField* field);
+
+    qint64 getBudget() const;
+    void setBudget(qint64 nsecs);
+    bool isRevealing() const;
+
+    void schedule(int origin, const QVector<int>& cells);
+    void clear();
+    void framePainted(qint64 nsecs);
+
+private:
+    Q_SLOT void tick();
+
+    MineField* field;
+    QTimer timer;
+    QVector<int> queue;         // cells in reveal order
+    int next = 0;               // first cell not shown yet
+    int shown = 0;              // cells shown by the last tick
+    int perFrame = 1024;        // cells shown per frame, adapted to the budget
+    qint64 budget = 8000000;    // painting time per frame in ns
+};
+
+#endif // REVEALSCHEDULER_H
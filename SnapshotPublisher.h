@@ -0,0 +1,124 @@
+#ifndef SNAPSHOTPUBLISHER_H
+#define SNAPSHOTPUBLISHER_H
+
+#include <QtCore/QtCore>
+
+// Publishes immutable values to any number of reader threads without locks.
+// The current node and the count of readers inside acquire() share one
+// atomic word: pointer in the low 48 bits, reader count in the high 16.
+// Replacing the node moves that count into the node's own reference count
+// (split reference counting), so a node is freed only after the last
+// reader released it and nobody can still be about to reference it
+template<typename T>
+class SnapshotPublisher
+{
+    struct Node
+    {
+        explicit Node(T value) : value(std::move(value)) {}
+
+        QAtomicInt references {1};
+        const T value;
+    };
+
+public:
+    // shared ownership of one published value, usable from any thread
+    class Handle
+    {
+    public:
+        Handle() = default;
+        Handle(const Handle& other) : node(other.node) { if(node) node->references.ref(); }
+        Handle(Handle&& other) : node(other.node) { other.node = nullptr; }
+        ~Handle() { release(node); }
+
+        Handle& operator=(Handle other)
+        {
+            std::swap(node, other.node);
+            return *this;
+        }
+
+        bool isNull() const { return !node; }
+        const T& operator*() const { return node->value; }
+        const T* operator->() const { return &node->value; }
+
+    private:
+        friend class SnapshotPublisher;
+        explicit Handle(Node* node) : node(node) {}
+
+        Node* node = nullptr;
+    };
+
+    explicit SnapshotPublisher(T initial = T())
+        : word(pack(new Node(std::move(initial))))
+    {}
+
+    ~SnapshotPublisher()
+    {
+        release(pointer(word.loadAcquire()));
+    }
+
+    Handle acquire() const
+    {
+        // announce the read, then take a real reference
+        quint64 current = word.fetchAndAddAcquire(Reader) + Reader;
+        Node* node = pointer(current);
+        node->references.ref();
+
+        // withdraw the announcement. When the node was replaced meanwhile,
+        // the announcement went into its reference count instead
+        for(;;)
+        {
+            if(pointer(current) != node)
+            {
+                node->references.deref();
+                break;
+            }
+            if(word.testAndSetOrdered(current, current - Reader, current))
+                break;
+        }
+        return Handle(node);
+    }
+
+    // called from one thread at a time
+    void publish(T value)
+    {
+        // readers may withdraw their announcement from the old node before
+        // the count is moved over, a bias keeps it alive until then
+        Node* old = pointer(word.loadAcquire());
+        old->references.fetchAndAddOrdered(Bias);
+        quint64 previous = word.fetchAndStoreOrdered(pack(new Node(std::move(value))));
+
+        // pending readers join the old node, the publisher leaves it
+        int readers = static_cast<int>(previous >> PointerBits);
+        if(old->references.fetchAndAddOrdered(readers - 1 - Bias) == Bias + 1 - readers)
+            delete old;
+    }
+
+private:
+    Q_DISABLE_COPY(SnapshotPublisher)
+
+    static const int PointerBits = 48;
+    static const quint64 Reader = Q_UINT64_C(1) << PointerBits;
+    static const int Bias = 1 << (64 - PointerBits);    // more than readers can announce
+
+    static quint64 pack(Node* node)
+    {
+        quint64 bits = reinterpret_cast<quintptr>(node);
+        Q_ASSERT(bits < Reader);
+        return bits;
+    }
+
+    static Node* pointer(quint64 word)
+    {
+        return reinterpret_cast<Node*>(static_cast<quintptr>(word & (Reader - 1)));
+    }
+
+    static void release(Node* node)
+    {
+        if(node && !node->references.deref())
+            delete node;
+    }
+
+    mutable QAtomicInteger<quint64> word;
+};
+
+#endif // SNAPSHOTPUBLISHER_H
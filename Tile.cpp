@@ -1,25 +1,21 @@
 #include "Tile.h"
 #include "MineSweeper.h"
-
-qreal TileSize = 32;
+#include "GLViewport.h"
+#include "TileAssets.h"
 
 struct TileData
 {
-    QPoint index;                      // tile pos - QPoint(col, row)
-    bool isMine = false;                        // has mine
-    Tile::State state = Tile::Cover;            // tile state
-    QMap<Qt::MouseButton, bool> isPressed = {   // mouse button pressed
-                                                {Qt::LeftButton, false},
-                                                {Qt::MidButton, false},
-                                                {Qt::RightButton, false}};
-    quint8 surroundingMines = 0;                              // surrounding mine counts
-    QMap<Direction, QSharedPointer<Tile> > neighbours;         // neighbours
-    MineSweeper* logic = MineSweeper::instance();
+    QPoint index;                           // tile pos - QPoint(col, row)
+    qreal size = 32;                        // edge length in scene pixels
+    Cell* cell = nullptr;                   // state of the current game
+    bool revealPending = false;             // logic changed, not shown yet
+    MineSweeper* logic = nullptr;           // game the tile is part of
 };
 
-Tile::Tile()
+Tile::Tile(MineSweeper* logic)
 {
     d = new TileData();
+    d->logic = logic;
     setAcceptedMouseButtons(Qt::LeftButton | Qt::MidButton | Qt::RightButton);
     setAcceptHoverEvents(true);
 }
@@ -29,23 +25,55 @@ Tile::~Tile()
     delete d;
 }
 
-qreal Tile::size()
+QColor Tile::numberColor(quint8 mines)
 {
-    return TileSize;
+    switch(mines)
+    {
+    case 1:
+        return Qt::blue;
+    case 2:
+        return Qt::green;
+    case 3:
+        return Qt::red;
+    case 4:
+        return Qt::darkBlue;
+    case 5:
+        return Qt::darkRed;
+    case 6:
+        return Qt::darkGreen;
+    case 7:
+        return Qt::darkGray;
+    case 8:
+        return Qt::black;
+    default:
+        return Qt::transparent;
+    }
 }
 
-void Tile::setSize(qreal newSize)
+void Tile::paintBackground(QPainter* painter, const QRect& rect,
+                           const QPoint& index, const QPalette& palette)
 {
-    TileSize = newSize;
+    painter->fillRect(rect, palette.color(QPalette::Active, QPalette::Button));
+    drawGrid(painter, rect, index, palette);
+    TileAssets::paintBevel(painter, rect, palette, false);
 }
 
 QRectF Tile::boundingRect() const
 {
-    return QRectF(0, 0, Tile::size(), Tile::size());
+    return QRectF(0, 0, d->size, d->size);
 }
 
 void Tile::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
 {
+    // the OpenGL viewport draws all tiles in one batch
+    auto gl = qobject_cast<GLViewport*>(widget);
+    if(gl && gl->isBatching())
+        return;
+
+    // the cached background already shows the plain covered look
+    if(isBackgroundLook())
+        return;
+
     painter->setRenderHint(QPainter::Antialiasing);
     painter->setRenderHint(QPainter::TextAntialiasing);
     painter->setRenderHint(QPainter::SmoothPixmapTransform);
@@ -60,12 +88,30 @@ void Tile::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWid
     painter->setPen(pen);
 
     fillTileRect(painter, option);
-    drawTileGrid(painter, option);
     drawTileImage(painter, option);
     drawTileBoarder(painter, option);
     drawTileText(painter, option);
 }
 
+void Tile::setCell(Cell* cell)
+{
+    d->cell = cell;
+    d->revealPending = false;
+}
+
+qreal Tile::size() const
+{
+    return d->size;
+}
+
+void Tile::setSize(qreal size)
+{
+    if(qFuzzyCompare(size, d->size))
+        return;
+    prepareGeometryChange();
+    d->size = size;
+}
+
 QPoint Tile::index() const
 {
     return d->index;
@@ -78,61 +124,63 @@ void Tile::setIndex(const QPoint& index)
 
 bool Tile::isMine() const
 {
-    return d->isMine;
+    return d->cell->isMine;
 }
 
 void Tile::setIsMine(bool isMine)
 {
-    d->isMine = isMine;
+    d->cell->isMine = isMine;
 }
 
 Tile::State Tile::state() const
 {
-    return d->state;
+    return d->cell->state;
 }
 
 void Tile::setState(State state)
 {
-    d->state = state;
+    d->cell->state = state;
 }
 
 bool Tile::isPressed(Qt::MouseButton button) const
 {
-    return d->isPressed.value(button);
+    return d->cell->isPressed(button);
 }
 
 void Tile::setPressed(Qt::MouseButton button, bool pressed)
 {
-    d->isPressed[button] = pressed;
+    d->cell->setPressed(button, pressed);
 }
 
 quint8 Tile::surroundingMines() const
 {
-    return d->surroundingMines;
+    return d->cell->surroundingMines;
 }
 
 void Tile::setSurroundingMines(quint8 mines)
 {
-    d->surroundingMines = mines;
+    d->cell->surroundingMines = mines;
 }
 
-QSharedPointer<Tile> Tile::neighbour(Direction pos) const
+bool Tile::isRevealPending() const
 {
-    return d->neighbours.value(pos);
+    return d->revealPending;
 }
 
-void Tile::setNeighbour(Direction pos, QSharedPointer<Tile> neighbour)
+void Tile::setRevealPending(bool pending)
 {
-    d->neighbours[pos] = neighbour;
+    d->revealPending = pending;
+}
+
+Tile::State Tile::shownState() const
+{
+    return d->revealPending ? Tile::Cover : state();
 }
 
 void Tile::mousePressEvent(QGraphicsSceneMouseEvent* event)
 {
-    Q_FOREACH(auto pressed, d->isPressed.values())
-    {
-        if(pressed)
-            return;
-    }
+    if(d->cell->pressed)
+        return;
 
     switch(event->button())
     {
@@ -159,7 +207,8 @@ void Tile::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
     case Qt::LeftButton:
     case Qt::MidButton:
     case Qt::RightButton:
-        if(isUnderMouse())
+        // the release position, the cursor may not follow synthesized events
+        if(contains(event->pos()))
             d->logic->click(index(), event->button());
         d->logic->setPressed(index(), event->button(), false);
         break;
@@ -173,7 +222,7 @@ void Tile::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 void Tile::fillTileRect(QPainter* painter, const QStyleOptionGraphicsItem* option)
 {
     QBrush brush;
-    switch(state())
+    switch(shownState())
     {
     case Tile::Uncover:
     case Tile::Explode:
@@ -188,101 +237,90 @@ void Tile::fillTileRect(QPainter* painter, const QStyleOptionGraphicsItem* optio
             brush = QBrush(option->palette.color(QPalette::Active, QPalette::Button));
         break;
     }
-    painter->fillRect(option->rect, brush);
+    // keep the grid lines of the background
+    painter->fillRect(option->rect.adjusted(index().x() > 0 ? 1 : 0,
+                                            index().y() > 0 ? 1 : 0,
+                                            0, 0),
+                      brush);
+}
+
+bool Tile::isBackgroundLook() const
+{
+    if(shownState() != Tile::Cover)
+        return false;
+    if(isUnderMouse() || isPressed(Qt::LeftButton) || isPressed(Qt::MidButton))
+        return false;
+    // covered mines are drawn once the game is over
+    return !isMine() || (d->logic->getState() == MineSweeper::State::Running);
 }
 
-void Tile::drawTileGrid(QPainter* painter, const QStyleOptionGraphicsItem* option)
+void Tile::drawGrid(QPainter* painter, const QRect& rect, const QPoint& index, const QPalette& palette)
 {
     painter->save();
     QPen pen = painter->pen();
     pen.setWidth(1);
-    pen.setColor(option->palette.background().color().darker());
+    pen.setColor(palette.background().color().darker());
     painter->setPen(pen);
-    if(neighbour(Direction::Top))
-        painter->drawLine(option->rect.topLeft(), option->rect.topRight());
-    if(neighbour(Direction::Left))
-        painter->drawLine(option->rect.topLeft(), option->rect.bottomLeft());
+    if(index.y() > 0)
+        painter->drawLine(rect.topLeft(), rect.topRight());
+    if(index.x() > 0)
+        painter->drawLine(rect.topLeft(), rect.bottomLeft());
     painter->restore();
 }
 
 void Tile::drawTileImage(QPainter* painter, const QStyleOptionGraphicsItem* option)
 {
-    QRectF tagRect(option->rect.x() + option->rect.width() / 4,
-                   option->rect.y() + option->rect.height() / 4,
-                   option->rect.width() / 2,
-                   option->rect.height() / 2);
-    QRectF explosionRect = option->rect;
-    QRectF mineRect(option->rect.x() + option->rect.width() / 10,
-                    option->rect.y() + option->rect.height() / 10,
-                    option->rect.width() * 4 / 5,
-                    option->rect.height() * 4 / 5);
-    switch(state())
+    // pre-rasterized for this tile size and pixel ratio, drawn unscaled
+    qreal ratio = painter->device()->devicePixelRatioF();
+    auto draw = [&](TileAssets::Image image)
+    {
+        painter->drawPixmap(TileAssets::rect(image, option->rect).topLeft(),
+                            TileAssets::pixmap(image, option->rect.width(), ratio));
+    };
+
+    switch(shownState())
     {
     case Tile::Flag:
-        painter->drawImage(tagRect, QImage(":/image/flag"));
+        draw(TileAssets::Flag);
         break;
     case Tile::Tag:
-        painter->drawImage(tagRect, QImage(":/image/tag"));
+        draw(TileAssets::Tag);
         break;
     case Tile::Explode:
-        painter->drawImage(explosionRect, QImage(":/image/explosion"));
+        draw(TileAssets::Explosion);
         break;
     case Tile::Uncover:
         if(isMine())
-            painter->drawImage(mineRect, QImage(":/image/mine"));
+            draw(TileAssets::Mine);
         break;
     case Tile::Cover:
-        if((d->logic->getState() != MineSweeper::State::Running) && (isMine()))
-            painter->drawImage(mineRect, QImage(":/image/mine"));
+        if((d->logic->getState() != MineSweeper::State::Running) && isMine() && !d->revealPending)
+            draw(TileAssets::Mine);
         break;
     }
 }
 
 void Tile::drawTileBoarder(QPainter* painter, const QStyleOptionGraphicsItem* option)
 {
-    painter->save();
-    QPen pen = painter->pen();
-    switch(state())
+    switch(shownState())
     {
     case Tile::Cover:
     case Tile::Flag:
     case Tile::Tag:
-    {
-        pen.setWidth(3);
-        QColor light = option->palette.background().color().lighter(1000);
-        QColor shadow = option->palette.background().color().darker(200);
-        bool pressed = isPressed(Qt::LeftButton)
-                       || isPressed(Qt::MidButton);
-
-        // draw light side of top and left
-        pen.setColor(pressed?shadow:light);
-        painter->setPen(pen);
-        painter->drawLine(option->rect.topLeft() + QPoint(1, 1),
-                          option->rect.topRight() + QPoint(-1, 1));
-        painter->drawLine(option->rect.topLeft() + QPoint(1, 1),
-                          option->rect.bottomLeft() + QPoint(1, -1));
-
-        // draw shadow side of bottom and right
-        pen.setColor(pressed?light:shadow);
-        painter->setPen(pen);
-        painter->drawLine(option->rect.topRight() + QPoint(-1, 3),
-                          option->rect.bottomRight() + QPoint(-1, -1));
-        painter->drawLine(option->rect.bottomLeft() + QPoint(3, -1),
-                          option->rect.bottomRight() + QPoint(-1, -1));
-    }
+        TileAssets::paintBevel(painter, option->rect, option->palette,
+                               isPressed(Qt::LeftButton) || isPressed(Qt::MidButton));
         break;
     case Tile::Explode:
     case Tile::Uncover:
         break;
     }
-    painter->restore();
 }
 
 void Tile::drawTileText(QPainter* painter, const QStyleOptionGraphicsItem* option)
 {
     painter->save();
     QPen pen = painter->pen();
-    switch(state())
+    switch(shownState())
     {
     case Tile::Cover:
     case Tile::Flag:
@@ -290,33 +328,7 @@ void Tile::drawTileText(QPainter* painter, const QStyleOptionGraphicsItem* optio
     case Tile::Explode:
         break;
     case Tile::Uncover:
-        switch(surroundingMines())
-        {
-        case 1:
-            pen.setColor(Qt::blue);
-            break;
-        case 2:
-            pen.setColor(Qt::green);
-            break;
-        case 3:
-            pen.setColor(Qt::red);
-            break;
-        case 4:
-            pen.setColor(Qt::darkBlue);
-            break;
-        case 5:
-            pen.setColor(Qt::darkRed);
-            break;
-        case 6:
-            pen.setColor(Qt::darkGreen);
-            break;
-        case 7:
-            pen.setColor(Qt::darkGray);
-            break;
-        case 8:
-            pen.setColor(Qt::black);
-            break;
-        }
+        pen.setColor(Tile::numberColor(surroundingMines()));
         if(surroundingMines() == 0)
             break;
         painter->setPen(pen);
@@ -3,37 +3,18 @@
 
 #include <QtCore/QtCore>
 #include <QtWidgets/QtWidgets>
+#include "Grid.h"
 
-enum class Direction {
-    TopLeft = 0,
-    Top,
-    TopRight,
-    Left,
-    Right,
-    BottomLeft,
-    Bottom,
-    BottomRight
-};
-
-const static QMap<Direction, QPoint> Directions {
-    {Direction::TopLeft, QPoint(-1, -1)},
-    {Direction::Top, QPoint(0, -1)},
-    {Direction::TopRight, QPoint(1, -1)},
-    {Direction::Left, QPoint(-1, 0)},
-    {Direction::Right, QPoint(1, 0)},
-    {Direction::BottomLeft, QPoint(-1, 1)},
-    {Direction::Bottom, QPoint(0, 1)},
-    {Direction::BottomRight, QPoint(1, 1)}
-};
-
+struct Cell;
 struct TileData;
+class MineSweeper;
 class Tile final : public QGraphicsItem
 {
 public:
-    Tile();
+    explicit Tile(MineSweeper* logic);
     ~Tile();
 
-    enum State {
+    enum State : quint8 {
         Cover = 0,
         Flag,
         Tag,
@@ -41,12 +22,20 @@ public:
         Uncover
     };
 
-    static qreal size();
-    static void setSize(qreal newSize);
+    static QColor numberColor(quint8 mines);
+    // static look of a covered tile: fill, grid lines and bevel. The view
+    // caches it as background, tiles looking like it paint nothing
+    static void paintBackground(QPainter* painter, const QRect& rect,
+                                const QPoint& index, const QPalette& palette);
 
     QRectF boundingRect() const override final;
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override final;
 
+    void setCell(Cell* cell);
+
+    qreal size() const;
+    void setSize(qreal size);
+
     QPoint index() const;
     void setIndex(const QPoint& index);
 
@@ -62,21 +51,46 @@ public:
     quint8 surroundingMines() const;
     void setSurroundingMines(quint8 mines);
 
-    QSharedPointer<Tile> neighbour(Direction pos) const;
-    void setNeighbour(Direction pos, QSharedPointer<Tile> neighbour);
+    // a pending reveal keeps the covered look until the view shows it
+    bool isRevealPending() const;
+    void setRevealPending(bool pending);
+    State shownState() const;
 
 protected:
     void mousePressEvent(QGraphicsSceneMouseEvent* event) override final;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override final;
 
 private:
+    bool isBackgroundLook() const;
     void fillTileRect(QPainter* painter, const QStyleOptionGraphicsItem* option);
-    void drawTileGrid(QPainter* painter, const QStyleOptionGraphicsItem* option);
     void drawTileImage(QPainter* painter, const QStyleOptionGraphicsItem* option);
     void drawTileBoarder(QPainter* painter, const QStyleOptionGraphicsItem* option);
     void drawTileText(QPainter* painter, const QStyleOptionGraphicsItem* option);
+    static void drawGrid(QPainter* painter, const QRect& rect, const QPoint& index, const QPalette& palette);
 
     TileData *d = nullptr;
 };
 
+// per game state of one tile, allocated from the game arena
+struct Cell
+{
+    bool isMine = false;                // has mine
+    Tile::State state = Tile::Cover;    // tile state
+    quint8 surroundingMines = 0;        // surrounding mine counts
+    quint8 pressed = 0;                 // pressed mouse buttons, Qt::MouseButton bits
+
+    bool isPressed(Qt::MouseButton button) const
+    {
+        return pressed & static_cast<quint8>(button);
+    }
+
+    void setPressed(Qt::MouseButton button, bool down)
+    {
+        if(down)
+            pressed |= static_cast<quint8>(button);
+        else
+            pressed &= ~static_cast<quint8>(button);
+    }
+};
+
 #endif // TILE_H
@@ -0,0 +1,97 @@
+#include "TileAssets.h"
+
+namespace {
+struct Key
+{
+    qreal tileSize;
+    qreal ratio;
+
+    bool operator==(const Key& other) const
+    {
+        return qFuzzyCompare(tileSize, other.tileSize) && qFuzzyCompare(ratio, other.ratio);
+    }
+};
+
+uint qHash(const Key& key, uint seed = 0)
+{
+    return ::qHash(qRound(key.tileSize * 1000), seed) ^ ::qHash(qRound(key.ratio * 1000));
+}
+
+const char* const Sources[TileAssets::ImageCount] = {
+    ":/image/flag",
+    ":/image/tag",
+    ":/image/explosion",
+    ":/image/mine"
+};
+}
+
+QRectF TileAssets::rect(Image image, const QRectF& tile)
+{
+    switch(image)
+    {
+    case Flag:
+    case Tag:
+        return QRectF(tile.x() + tile.width() / 4,
+                      tile.y() + tile.height() / 4,
+                      tile.width() / 2,
+                      tile.height() / 2);
+    case Mine:
+        return QRectF(tile.x() + tile.width() / 10,
+                      tile.y() + tile.height() / 10,
+                      tile.width() * 4 / 5,
+                      tile.height() * 4 / 5);
+    case Explosion:
+    case ImageCount:
+        break;
+    }
+    return tile;
+}
+
+const QPixmap& TileAssets::pixmap(Image image, qreal tileSize, qreal ratio)
+{
+    // screens change rarely, every key seen stays cached
+    static QHash<Key, QVector<QPixmap> > cache;
+    QVector<QPixmap>& pixmaps = cache[Key{tileSize, ratio}];
+    if(pixmaps.isEmpty())
+    {
+        pixmaps.resize(ImageCount);
+        for(int i=0;i<ImageCount;++i)
+        {
+            QSizeF size = rect(static_cast<Image>(i), QRectF(0, 0, tileSize, tileSize)).size();
+            QImage source(QString::fromLatin1(Sources[i]));
+            QPixmap pixmap = QPixmap::fromImage(source.scaled(qRound(size.width() * ratio),
+                                                              qRound(size.height() * ratio),
+                                                              Qt::IgnoreAspectRatio,
+                                                              Qt::SmoothTransformation));
+            pixmap.setDevicePixelRatio(ratio);
+            pixmaps[i] = pixmap;
+        }
+    }
+    return pixmaps.at(image);
+}
+
+void TileAssets::paintBevel(QPainter* painter, const QRect& rect, const QPalette& palette, bool pressed)
+{
+    painter->save();
+    QPen pen = painter->pen();
+    pen.setWidth(3);
+    QColor light = palette.background().color().lighter(1000);
+    QColor shadow = palette.background().color().darker(200);
+
+    // draw light side of top and left
+    pen.setColor(pressed?shadow:light);
+    painter->setPen(pen);
+    painter->drawLine(rect.topLeft() + QPoint(1, 1),
+                      rect.topRight() + QPoint(-1, 1));
+    painter->drawLine(rect.topLeft() + QPoint(1, 1),
+                      rect.bottomLeft() + QPoint(1, -1));
+
+    // draw shadow side of bottom and right
+    pen.setColor(pressed?light:shadow);
+    painter->setPen(pen);
+    painter->drawLine(rect.topRight() + QPoint(-1, 3),
+                      rect.bottomRight() + QPoint(-1, -1));
+    painter->drawLine(rect.bottomLeft() + QPoint(3, -1),
+                      rect.bottomRight() + QPoint(-1, -1));
+    painter->restore();
+}
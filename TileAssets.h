@@ -0,0 +1,28 @@
+#ifndef TILEASSETS_H
+#define TILEASSETS_H
+
+#include <QtCore/QtCore>
+#include <QtGui/QtGui>
+
+// Tile images rasterized once per tile size and device pixel ratio, so
+// painting is a blit without scaling. A new screen or DPI gives new keys.
+class TileAssets
+{
+public:
+    enum Image {
+        Flag = 0,
+        Tag,
+        Explosion,
+        Mine,
+        ImageCount
+    };
+
+    // area of the image inside a tile
+    static QRectF rect(Image image, const QRectF& tile);
+    static const QPixmap& pixmap(Image image, qreal tileSize, qreal ratio);
+    // raised edges of a covered tile, sunken when pressed. Shared by the
+    // scene items and the atlas of the GL view
+    static void paintBevel(QPainter* painter, const QRect& rect, const QPalette& palette, bool pressed);
+};
+
+#endif // TILEASSETS_H
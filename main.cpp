@@ -1,12 +1,64 @@
 #include "MainWindow.h"
+#include "Benchmark.h"
+#include "BotServer.h"
 #include <QApplication>
 
 int main(int argc, char* argv[])
 {
     QApplication a(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption benchmark(QStringLiteral("benchmark"),
+                                 QStringLiteral("Run benchmark <name> and quit: %1.")
+                                 .arg(Benchmark::names().join(QStringLiteral(", "))),
+                                 QStringLiteral("name"));
+    parser.addOption(benchmark);
+    QCommandLineOption latency(QStringLiteral("latency"),
+                               QStringLiteral("Print mouse event to pixel latency on exit."));
+    parser.addOption(latency);
+    QCommandLineOption botServer(QStringLiteral("bot-server"),
+                                 QStringLiteral("Serve games to bots on local socket <name>, "
+                                                "without a window."),
+                                 QStringLiteral("name"));
+    parser.addOption(botServer);
+    QCommandLineOption botWindow(QStringLiteral("bot-window"),
+                                 QStringLiteral("Let bots play the game in the window "
+                                                "through local socket <name>."),
+                                 QStringLiteral("name"));
+    parser.addOption(botWindow);
+    parser.process(a);
+    if(parser.isSet(benchmark))
+        return Benchmark::run(parser.values(benchmark));
+
+    if(parser.isSet(botServer))
+    {
+        BotServer server;
+        if(!server.listen(parser.value(botServer)))
+        {
+            QTextStream(stderr) << server.errorString() << endl;
+            return 1;
+        }
+        return a.exec();
+    }
+
     MainWindow w;
     w.show();
 
-    return a.exec();
+    QScopedPointer<BotServer> server;
+    if(parser.isSet(botWindow))
+    {
+        server.reset(new BotServer(w.getLogic()));
+        if(!server->listen(parser.value(botWindow)))
+        {
+            QTextStream(stderr) << server->errorString() << endl;
+            return 1;
+        }
+        w.attach(server.data());
+    }
+
+    int result = a.exec();
+    if(parser.isSet(latency))
+        QTextStream(stdout) << w.latencyReport() << endl;
+    return result;
 }